@@ -7,24 +7,36 @@
 #include <SFML/Graphics/RectangleShape.hpp>
 #include <SFML/Graphics/Font.hpp>
 #include <SFML/Graphics/Text.hpp>
+#include <SFML/Graphics/Image.hpp>
+#include <array>
+#include <cstdint>
+#include <filesystem>
 #include <memory>
-
-#include "game/GameState.hpp"
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "core/BackgroundIo.hpp"
+#include "core/FramePacer.hpp"
+#include "core/FrameProfiler.hpp"
+#include "core/LatencyProbe.hpp"
+#include "core/LaunchOptions.hpp"
+#include "core/ResourceCache.hpp"
+#include "core/ScoreStore.hpp"
+#include "core/SimulationThread.hpp"
+#include "core/StartupReport.hpp"
+#include "core/Telemetry.hpp"
+#include "game/Fumen.hpp"
+#include "game/Simulation.hpp"
+#include "render/InstrumentedTarget.hpp"
 #include "render/PlayfieldRenderer.hpp"
+#include "render/FrameProfilerOverlay.hpp"
 #include "render/Hud.hpp"
+#include "render/RenderStatsOverlay.hpp"
 
 namespace Tetris {
 
-struct MoveSettings {
-    float das = 0.16f;   // seconds
-    float arr = 0.033f;  // seconds
-};
-
-struct MoveKeyState {
-    bool  held      = false;
-    float heldTime  = 0.f; // total time key has been held
-};
-
 enum class AppMode {
     Title,
     Playing,
@@ -38,6 +50,18 @@ enum class MenuItem {
     Config
 };
 
+// Title screen images; all of them live in one atlas texture.
+enum class TitleImage {
+    Bg,
+    HomeBar,
+    Sprint,
+    Endless,
+    Blitz,
+    Config,
+    Count
+};
+constexpr std::size_t kTitleImageCount = static_cast<std::size_t>(TitleImage::Count);
+
 // Simple UI slider used on the config screen
 struct Slider {
     sf::RectangleShape track;
@@ -49,11 +73,13 @@ struct Slider {
     float maxValue   = 1.f;
     float* boundValue = nullptr;   // points into MoveSettings
     bool  dragging   = false;
+
+    std::string (*format)(float) = nullptr; // value text; seconds as "160 ms" if null
 };
 
 class Application {
 public:
-    Application();
+    explicit Application(const LaunchOptions& options = {});
     void run();
 
 private:
@@ -61,18 +87,25 @@ private:
     void update(float dt);
     void render();
     void renderTitle();
-    void initTitleSprites();
+    void initTitleSprites(const std::array<std::shared_ptr<const sf::Image>, kTitleImageCount>& images);
+    sf::Vector2u titleImageSize(TitleImage img) const;
     void updateMenuHighlight();
     sf::Sprite& spriteForMenu(MenuItem item);
     void startGame();
+    void recordRunResult(); // once the run ends: queue it for the score store
+    void updateSprintBest(); // I/O thread: refresh m_pbReplay from the store
 
-    void updateAutoShift(float dt);
+    // practice boards from fumen strings (Ctrl+V on the title, --practice)
+    bool loadPractice(std::string_view fumen);
+    void startPractice();         // the current page, as a run that isn't scored
+    void copyBoardAsFumen();      // Ctrl+C in a run: the board to the clipboard
 
 	 // helper to configure GameState for a run type
 	void setupRunForMenuSelection();
 
     // --- config screen UI ---
     void initConfigUi();
+    void ensureConfigUi(); // builds the config UI on first visit
     void renderConfig();
 
     // slider helpers (config screen)
@@ -83,7 +116,8 @@ private:
         float maxValue,
         float* boundValue,
         float centerX,
-        float y
+        float y,
+        std::string (*format)(float) = nullptr
     );
     void updateSliderVisual(Slider& slider);
     void onConfigMousePressed(const sf::Vector2f& mousePos);
@@ -91,23 +125,71 @@ private:
     void onConfigMouseMoved(const sf::Vector2f& mousePos);
 
     void loadConfig();
-    void saveConfig() const;
+    void saveConfig();
+    void writeLatencyCsv();
 
-    sf::RenderWindow  m_window;
-    GameState         m_state;
+    StartupReport     m_startup; // first member: its clock starts the report
+    ResourceCache     m_resources;
+    sf::RenderWindow   m_window;
+    InstrumentedTarget m_target{m_window}; // renderers draw through this
     PlayfieldRenderer m_playfield;
     Hud               m_hud;
+#ifdef TETRIS_RENDER_STATS
+    RenderStatsOverlay m_statsOverlay{m_target};
+#endif
+
+    FramePacer           m_pacer;
+    PacingSettings       m_pacing; // config.json "pacing" / "fpsCap"
+    FrameProfiler        m_profiler;
+    FrameProfilerOverlay m_profilerOverlay{m_target, m_profiler};
+
+    // --telemetry: per-frame sample published after display()
+    TelemetryPublisher m_telemetry;
+    std::uint64_t      m_frameIndex       = 0;
+    std::uint32_t      m_frameInputEvents = 0;
+
+    // --latency: input-to-display histograms
+    LatencyProbe  m_latency;
+    std::uint32_t m_renderedInputSeq = 0; // RenderSnapshot::inputSeq drawn this frame
+    float         m_latencyRefresh   = 0.f;
 
     AppMode  m_mode;
     MenuItem m_selectedMenu;
 
-    MoveSettings m_moveSettings;
-    MoveKeyState m_leftState;
-    MoveKeyState m_rightState;
+    // one store per RunType, opened on the I/O thread and only ever used
+    // from jobs on it (resources/scores)
+    std::array<ScoreStore, 3> m_scores;
+
+    // best finished 40L replay for the ghost race, kept up to date by the
+    // score jobs so starting a Sprint needs no disk access
+    std::mutex  m_pbMutex;
+    std::string m_pbReplay; // file name; empty: nothing to race
+
+    // all disk writes (config, scores, replays); after the stores it uses,
+    // before the simulation that queues replay chunks on it
+    BackgroundIo m_io;
+
+    // gameplay: rules + state live on the simulation thread
+    SimulationThread m_sim{m_io};
+    RunType          m_runType = RunType::Endless;
+    MoveSettings     m_moveSettings; // edited on the config screen, copied into each run
+    std::filesystem::path m_runReplay;   // replay being recorded for the current run
+    std::uint64_t         m_runSeed    = 0;
+    std::int64_t          m_runStarted = 0; // unix seconds
+    bool                  m_runResolved = false; // current run's result recorded
+    bool                  m_ghostRace   = true;  // config.json "ghostRace"
+
+    // practice: a pasted board instead of a fresh run, never recorded or
+    // scored; R restarts the page, Tab moves on to the next one
+    std::vector<FumenPage> m_practicePages;
+    std::size_t            m_practicePage = 0;
+    bool                   m_practice     = false;
+
+    // UI font, shared by the HUD and the config screen (null if missing)
+    std::shared_ptr<const sf::Font> m_uiFont;
 
     // config text
-    sf::Font m_cfgFont;
-    bool m_cfgFontOk = false;
+    bool m_cfgUiReady = false;
     std::unique_ptr<sf::Text> m_cfgTitle;
     std::unique_ptr<sf::Text> m_cfgBody;
     std::unique_ptr<sf::Text> m_cfgHint;
@@ -115,14 +197,11 @@ private:
     // config sliders
     Slider m_dasSlider;
     Slider m_arrSlider;
+    Slider m_sdfSlider;
 
-    // title screen textures
-    sf::Texture m_titleBgTex;
-    sf::Texture m_homeBarTex;
-    sf::Texture m_sprintTex;
-    sf::Texture m_endlessTex;
-    sf::Texture m_blitzTex;
-    sf::Texture m_configTex;
+    // title screen atlas (all title images packed into one texture)
+    sf::Texture m_titleAtlas;
+    std::array<sf::IntRect, kTitleImageCount> m_titleRects{};
 
     // title screen sprites
     std::unique_ptr<sf::Sprite> m_titleBgSprite;
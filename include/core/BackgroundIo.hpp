@@ -0,0 +1,74 @@
+// BackgroundIo.hpp
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+
+namespace Tetris {
+
+// The one thread that touches the disk for the game: config saves, score
+// records, replay files and debug dumps. Callers only queue work (one short
+// lock) and never wait for the writer, so no file I/O -- and no stalled
+// disk -- ever holds up a frame or a simulation tick.
+//
+// The queue itself is unbounded; what keeps it small is that nothing
+// queues per-tick work. Writes of a whole file go through writeFile(),
+// which replaces the target atomically (temp file, fsync, rename) and
+// coalesces: saving the same file again while the first save is still
+// queued just swaps in the new contents. Streams (ReplayWriter) coalesce
+// their own data and keep at most one job queued. Directory syncs are
+// batched -- the writer takes everything queued at once and syncs each
+// touched directory once at the end.
+class BackgroundIo {
+public:
+    BackgroundIo();
+    ~BackgroundIo(); // runs whatever is still queued, then joins
+    BackgroundIo(const BackgroundIo&) = delete;
+    BackgroundIo& operator=(const BackgroundIo&) = delete;
+
+    // Atomically replace `path` with `contents` (parent directories are
+    // created). Failures are logged on the writer thread.
+    void writeFile(std::filesystem::path path, std::string contents);
+
+    // Any other disk work, run in order with the writes.
+    void post(std::function<void()> job);
+
+    // Writer thread only (from inside a posted job): sync `dir` once when
+    // the current batch is done instead of after every file.
+    void syncDirectoryLater(const std::filesystem::path& dir);
+
+    // Blocks until everything queued so far is on disk.
+    void flush();
+
+private:
+    struct Job {
+        std::filesystem::path path;     // writeFile: target; empty for post()
+        std::string           contents;
+        std::function<void()> run;
+    };
+
+    void workerLoop();
+    void enqueue(Job job);
+    void replace(const Job& job);
+
+    std::deque<Job>         m_jobs;
+    std::mutex              m_mutex;
+    std::condition_variable m_wake;    // writer: work or stop
+    std::condition_variable m_idle;    // flush(): a batch is done
+    std::uint64_t           m_queued   = 0; // jobs ever queued
+    std::uint64_t           m_done     = 0; // jobs finished (incl. their dir sync)
+    bool                    m_stopping = false;
+
+    std::set<std::filesystem::path> m_dirtyDirs; // writer thread only
+
+    std::thread m_thread; // last: started once everything above exists
+};
+
+} // namespace Tetris
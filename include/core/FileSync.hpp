@@ -0,0 +1,23 @@
+// FileSync.hpp
+#pragma once
+
+#include <cstdio>
+#include <filesystem>
+
+namespace Tetris {
+
+// Durability helpers for files that must survive a crash or power loss.
+
+// fflush + fsync (FlushFileBuffers on Windows).
+bool syncFile(std::FILE* f);
+
+// Makes a rename / create in `dir` durable. No-op on Windows, where the
+// rename itself is written through.
+bool syncDirectory(const std::filesystem::path& dir);
+
+// Atomically replaces `target` with the already-synced `tmp`: afterwards
+// readers see either the old or the new file, never a mix. Pass
+// syncDir = false to syncDirectory() the parent later, once for many files.
+bool replaceFile(const std::filesystem::path& tmp, const std::filesystem::path& target, bool syncDir = true);
+
+} // namespace Tetris
@@ -0,0 +1,66 @@
+// FramePacer.hpp
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#include "core/FrameProfiler.hpp"
+
+namespace sf { class Window; }
+
+namespace Tetris {
+
+enum class PacingMode : std::uint8_t {
+    Capped,    // FramePacer deadline at fpsCap
+    Uncapped,  // render as fast as possible
+    VSync      // let the driver's buffer swap pace frames
+};
+
+const char* pacingModeName(PacingMode mode);
+bool parsePacingMode(const char* name, PacingMode& out);
+
+struct PacingSettings {
+    PacingMode mode   = PacingMode::Capped;
+    float      fpsCap = 240.f;
+};
+
+// Replaces sf::Window::setFramerateLimit, which only sleeps and so wakes up
+// anywhere up to a scheduler quantum late. wait() sleeps until shortly
+// before the deadline, then spins on the clock for the rest. The sleep
+// margin adapts to the overshoot this machine's sleeps actually show.
+//
+// Deadlines follow a fixed grid (last deadline + period) so small errors
+// don't accumulate; after a long hitch the grid restarts from now instead
+// of rushing several frames out back to back.
+class FramePacer {
+public:
+    using clock = std::chrono::steady_clock;
+
+    FramePacer();
+    ~FramePacer();
+    FramePacer(const FramePacer&) = delete;
+    FramePacer& operator=(const FramePacer&) = delete;
+
+    // Applies vsync / limiter state to the window and resets the grid.
+    void configure(sf::Window& window, const PacingSettings& settings);
+
+    // Call once per frame, after display(). Returns immediately unless Capped.
+    void wait();
+
+    // Wake-up time minus deadline for paced frames since the last report.
+    const DurationHistogram& error() const { return m_error; }
+
+private:
+    void report(clock::time_point now);
+
+    PacingSettings    m_settings;
+    clock::duration   m_period{};
+    clock::time_point m_deadline{};
+    clock::duration   m_sleepMargin;   // spin this long before the deadline
+
+    DurationHistogram m_error;
+    std::uint64_t     m_missed = 0; // frames that ended after their deadline
+    clock::time_point m_lastReport{};
+};
+
+} // namespace Tetris
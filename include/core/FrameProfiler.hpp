@@ -0,0 +1,101 @@
+// FrameProfiler.hpp
+#pragma once
+
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace Tetris {
+
+enum class FramePhase : std::uint8_t {
+    Events,   // processEvents()
+    Update,   // update()
+    Render,   // render(), up to but excluding display()
+    Display,  // m_window.display(): buffer swap + vsync wait
+    Frame,    // start of frame to start of next frame
+    Count
+};
+constexpr std::size_t kFramePhaseCount = static_cast<std::size_t>(FramePhase::Count);
+
+const char* framePhaseName(FramePhase p);
+
+// Fixed-size log-linear histogram of durations in nanoseconds: 64 linear
+// sub-buckets per power of two (~1.5% resolution), 0 ns .. ~4 s.
+class DurationHistogram {
+public:
+    static constexpr std::size_t kSub     = 64;
+    static constexpr std::size_t kBuckets = kSub + 26 * kSub;
+
+    void add(std::uint64_t ns) {
+        ++m_counts[bucketOf(ns)];
+        ++m_total;
+        if (ns > m_max) m_max = ns;
+    }
+
+    void reset() { *this = {}; }
+
+    std::uint64_t count() const { return m_total; }
+    std::uint64_t maxNs() const { return m_max; }
+
+    // Approximate value at quantile q in [0,1] (bucket midpoint).
+    std::uint64_t percentileNs(double q) const;
+
+private:
+    static std::size_t bucketOf(std::uint64_t ns) {
+        if (ns < kSub) return static_cast<std::size_t>(ns);
+        const unsigned shift = static_cast<unsigned>(std::bit_width(ns)) - 7; // ns >> shift in [64,128)
+        const std::size_t idx = kSub + shift * kSub + static_cast<std::size_t>((ns >> shift) - kSub);
+        return idx < kBuckets ? idx : kBuckets - 1;
+    }
+
+    static std::uint64_t bucketMidNs(std::size_t idx) {
+        if (idx < kSub) return idx;
+        const std::size_t shift = (idx - kSub) / kSub;
+        const std::uint64_t lo  = (kSub + (idx - kSub) % kSub) << shift;
+        return lo + ((std::uint64_t{1} << shift) >> 1);
+    }
+
+    std::array<std::uint32_t, kBuckets> m_counts{};
+    std::uint64_t m_total = 0;
+    std::uint64_t m_max   = 0;
+};
+
+// Per-phase frame timing for Application::run(). record() is a handful of
+// integer ops on preallocated arrays: no locks, no allocation.
+class FrameProfiler {
+public:
+    using clock = std::chrono::steady_clock;
+    static constexpr std::size_t kGraphFrames = 240; // recent frames kept for the graph
+
+    // Durations of Events, Update, Render, Display for one frame plus the
+    // full frame interval, in that order (FramePhase).
+    void record(const std::array<clock::duration, kFramePhaseCount>& phases) {
+        for (std::size_t i = 0; i < kFramePhaseCount; ++i) {
+            const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(phases[i]).count();
+            m_hist[i].add(ns > 0 ? static_cast<std::uint64_t>(ns) : 0u);
+        }
+        const auto frame = phases[static_cast<std::size_t>(FramePhase::Frame)];
+        m_recent[m_recentPos] = std::chrono::duration<float, std::milli>(frame).count();
+        m_recentPos = (m_recentPos + 1) % kGraphFrames;
+    }
+
+    void reset() {
+        for (auto& h : m_hist) h.reset();
+        m_recent.fill(0.f);
+        m_recentPos = 0;
+    }
+
+    const DurationHistogram& histogram(FramePhase p) const { return m_hist[static_cast<std::size_t>(p)]; }
+
+    // Frame times in ms, oldest first; i in [0, kGraphFrames).
+    float recentFrameMs(std::size_t i) const { return m_recent[(m_recentPos + i) % kGraphFrames]; }
+
+private:
+    std::array<DurationHistogram, kFramePhaseCount> m_hist{};
+    std::array<float, kGraphFrames>                 m_recent{};
+    std::size_t                                     m_recentPos = 0;
+};
+
+} // namespace Tetris
@@ -0,0 +1,80 @@
+// LatencyProbe.hpp
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "core/FrameProfiler.hpp"
+#include "game/Simulation.hpp"
+
+namespace Tetris {
+
+enum class LatencyAction : std::uint8_t {
+    Move,      // left / right / soft drop
+    Rotate,    // cw / ccw / 180
+    HardDrop,
+    Hold,
+    Count
+};
+constexpr std::size_t kLatencyActionCount = static_cast<std::size_t>(LatencyAction::Count);
+
+const char* latencyActionName(LatencyAction a);
+LatencyAction latencyActionOf(InputAction a);
+
+// Input-to-display latency (--latency). Every gameplay key press gets the
+// sequence number the simulation thread assigned it; snapshots carry the
+// newest sequence number the simulation has applied. When display() returns
+// for a frame that drew snapshot N, every tracked input <= N has become
+// visible and its latency is display-return time minus arrival time.
+//
+// Window thread only.
+class LatencyProbe {
+public:
+    using clock = std::chrono::steady_clock;
+    static constexpr std::size_t kMaxPending = 256; // inputs in flight
+
+    bool enabled() const { return m_enabled; }
+    void setEnabled(bool on) { m_enabled = on; }
+
+    void track(std::uint32_t seq, InputAction action, clock::time_point arrived);
+    void onDisplayed(std::uint32_t appliedSeq, clock::time_point displayed);
+
+    // inputs of a finished run will never show up; forget them
+    void dropPending() { m_head = m_tail; }
+    void reset();
+
+    const DurationHistogram& histogram(LatencyAction a) const { return m_hist[static_cast<std::size_t>(a)]; }
+
+    // "move p50 / p99 ms" lines for the HUD
+    std::string summary() const;
+    // one row per resolved input; the caller writes it out (BackgroundIo)
+    std::string csv() const;
+
+private:
+    struct Pending {
+        std::uint32_t     seq = 0;
+        LatencyAction     action = LatencyAction::Move;
+        clock::time_point arrived{};
+    };
+    struct Sample {
+        std::uint32_t seq;
+        LatencyAction action;
+        std::int64_t  arrivedUs;  // since the probe was reset
+        std::int64_t  latencyUs;
+    };
+
+    bool m_enabled = false;
+
+    std::array<Pending, kMaxPending> m_pending{};
+    std::size_t m_head = 0; // oldest unresolved
+    std::size_t m_tail = 0; // next free
+
+    std::array<DurationHistogram, kLatencyActionCount> m_hist{};
+    std::vector<Sample> m_samples;
+    clock::time_point   m_epoch = clock::now();
+};
+
+} // namespace Tetris
@@ -0,0 +1,19 @@
+// LaunchOptions.hpp
+#pragma once
+
+#include <filesystem>
+#include <string>
+
+namespace Tetris {
+
+// Command-line switches, parsed once in main().
+struct LaunchOptions {
+    std::filesystem::path tracePath;     // --trace [file]: Chrome trace output, empty = off
+    std::string           telemetryName; // --telemetry [name]: shared-memory ring, empty = off
+    bool                  latency = false; // --latency: input-to-display histograms
+    std::string           practice;      // --practice <fumen|file>: start on that board
+};
+
+LaunchOptions parseLaunchOptions(int argc, char** argv);
+
+} // namespace Tetris
@@ -0,0 +1,38 @@
+// MappedFile.hpp
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+
+namespace Tetris {
+
+// Read-only memory mapping of a whole file. Move-only; unmaps on destruction.
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile() { close(); }
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Returns false (and stays closed) if the file can't be opened or mapped.
+    bool open(const std::filesystem::path& path);
+    void close();
+
+    bool                 isOpen() const { return m_data != nullptr || m_openEmpty; }
+    const unsigned char* data()   const { return m_data; }
+    std::size_t          size()   const { return m_size; }
+
+private:
+    const unsigned char* m_data = nullptr;
+    std::size_t          m_size = 0;
+    bool                 m_openEmpty = false; // zero-length files can't be mapped
+#ifdef _WIN32
+    void* m_file    = nullptr;
+    void* m_mapping = nullptr;
+#endif
+};
+
+} // namespace Tetris
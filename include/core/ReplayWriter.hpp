@@ -0,0 +1,61 @@
+// ReplayWriter.hpp
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "core/BackgroundIo.hpp"
+
+namespace Tetris {
+
+// Writes replay files on the BackgroundIo thread. The calls only queue a
+// job, so the simulation thread never waits on the disk; the single writer
+// keeps the jobs of a file in order. The file is written as `<path>.part`
+// and renamed into place, synced, once finished, so a replay on disk under
+// its real name is always complete.
+//
+// Appended bytes collect in the file's pending buffer and one queued job
+// writes out whatever has collected by the time it runs, so a slow disk
+// grows that buffer, not the I/O queue. Past kMaxPendingBytes (minutes of
+// play) the disk is taken to be stuck: the replay is dropped and the
+// writer reports it, the run itself goes on.
+class ReplayWriter {
+public:
+    static constexpr std::size_t kChunkBytes      = 4096;    // flush threshold for callers
+    static constexpr std::size_t kMaxPendingBytes = 1 << 20; // see above
+
+    explicit ReplayWriter(BackgroundIo& io) : m_io(io) {}
+
+    void begin(std::filesystem::path path);
+    void append(std::vector<std::uint8_t> bytes);
+    void finish(); // sync, close and rename; logs the final size
+
+private:
+    // shared with the queued jobs so none outlives what it writes to
+    struct File {
+        ~File() { if (out) std::fclose(out); }
+
+        std::mutex                mutex;   // pending + dropped (caller and writer)
+        std::vector<std::uint8_t> pending;
+        bool                      dropped = false;
+
+        // writer thread only
+        std::vector<std::uint8_t> writing; // swapped with `pending`, keeps its capacity
+        std::FILE*            out = nullptr;
+        std::filesystem::path path;
+        std::filesystem::path part;
+        std::uintmax_t        bytes = 0;
+        bool                  failed = false;
+    };
+
+    static void drain(File& file);
+
+    BackgroundIo&         m_io;
+    std::shared_ptr<File> m_file; // current replay (caller side)
+};
+
+} // namespace Tetris
@@ -0,0 +1,63 @@
+// ResourceCache.hpp
+#pragma once
+
+#include <SFML/Graphics/Font.hpp>
+#include <SFML/Graphics/Image.hpp>
+
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "core/ResourcePack.hpp"
+
+namespace Tetris {
+
+// Central, thread-safe asset cache. Assets are looked up by their path below
+// resources/ ("fonts/DejaVuSans.ttf") and come from resources.pak when it is
+// present (zero-copy via openFromMemory / loadFromMemory), otherwise from the
+// loose resources/ folder. Each asset is loaded exactly once while anyone
+// still holds a reference; the cache itself only keeps weak references.
+class ResourceCache {
+public:
+    ResourceCache(); // locates resources.pak / resources/ next to the working dir
+
+    std::shared_ptr<const sf::Font>  font(const std::string& name);
+    std::shared_ptr<const sf::Image> image(const std::string& name);
+
+    bool usingPack() const { return m_pack != nullptr; }
+
+private:
+    // Raw file bytes: a view into the pack, or an owned copy of a loose file.
+    struct Blob {
+        std::shared_ptr<const ResourcePack> pack; // keeps the mapping alive
+        std::vector<unsigned char>          owned;
+        std::span<const unsigned char>      bytes;
+    };
+
+    template<class T>
+    struct Slot {
+        std::mutex            mutex; // serialises the load of this one asset
+        std::weak_ptr<const T> value;
+    };
+
+    template<class T>
+    using SlotMap = std::unordered_map<std::string, std::shared_ptr<Slot<T>>>;
+
+    template<class T, class Load>
+    std::shared_ptr<const T> getOrLoad(SlotMap<T>& slots, const std::string& name, Load&& load);
+
+    std::shared_ptr<const Blob> blob(const std::string& name) const;
+
+    std::shared_ptr<const ResourcePack> m_pack;
+    std::filesystem::path               m_looseRoot;
+
+    std::mutex        m_mutex; // guards the slot maps only
+    SlotMap<sf::Font>  m_fonts;
+    SlotMap<sf::Image> m_images;
+};
+
+} // namespace Tetris
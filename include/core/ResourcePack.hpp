@@ -0,0 +1,55 @@
+// ResourcePack.hpp
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "core/MappedFile.hpp"
+
+namespace Tetris {
+
+// resources.pak layout (little-endian), written by tools/respack.cpp:
+//   PakHeader
+//   file blobs, each starting on a kPakAlign boundary
+//   index: count x { u64 offset, u64 size, u32 nameLen, name bytes },
+//          sorted by name; names are '/'-separated paths below resources/
+inline constexpr char          kPakMagic[8] = {'T', 'S', 'R', 'S', 'P', 'A', 'K', '\0'};
+inline constexpr std::uint32_t kPakVersion  = 1;
+inline constexpr std::uint64_t kPakAlign    = 16;
+
+struct PakHeader {
+    char          magic[8];
+    std::uint32_t version;
+    std::uint32_t count;
+    std::uint64_t indexOffset;
+    std::uint64_t indexSize;
+};
+static_assert(sizeof(PakHeader) == 32, "PakHeader is part of the file format");
+
+// Memory-mapped, read-only view of a resources.pak. Lookups return spans
+// straight into the mapping (no copies); they stay valid while the pack lives.
+class ResourcePack {
+public:
+    bool open(const std::filesystem::path& path);
+    bool isOpen() const { return m_file.isOpen(); }
+
+    // Bytes of `name` (e.g. "fonts/DejaVuSans.ttf"), or an empty span.
+    std::span<const unsigned char> find(std::string_view name) const;
+
+    std::size_t entryCount() const { return m_entries.size(); }
+
+private:
+    struct Entry {
+        std::string_view name;
+        std::uint64_t    offset;
+        std::uint64_t    size;
+    };
+
+    MappedFile         m_file;
+    std::vector<Entry> m_entries; // sorted by name
+};
+
+} // namespace Tetris
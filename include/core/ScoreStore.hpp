@@ -0,0 +1,94 @@
+// ScoreStore.hpp
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "core/MappedFile.hpp"
+#include "game/GameState.hpp"
+
+namespace Tetris {
+
+struct ScoreRecord {
+    RunType       run      = RunType::Sprint;
+    bool          finished = false;   // Sprint: reached 40 lines; others: ended normally
+    std::uint32_t lines    = 0;
+    std::uint32_t pieces   = 0;
+    std::int64_t  timeUs   = 0;       // Sprint time, else run length
+    std::int64_t  dateUnix = 0;
+    std::uint64_t seed     = 0;
+    std::string   replay;             // replay file name (no directory), may be empty
+};
+
+// Scores of one run type: an append-only data file plus a sorted index.
+//
+//   <mode>.scores  header (16 bytes), then fixed-size records (96 bytes,
+//                  CRC-32 each), only ever appended
+//   <mode>.index   header (32 bytes), then (u64 rankKey, u64 record) pairs
+//                  sorted by key, covering the first `covered` records
+//
+// Records appended since the last compaction (the tail, at most
+// kMaxTail) are kept sorted in memory; queries combine a binary search of
+// the mapped index with the tail, so top-K, best and rank never scan the
+// data file. compact() folds the tail into a new index written beside the
+// old one and renamed over it, so a crash leaves either index intact; the
+// data file is never rewritten, and a torn final record is cut off on open.
+class ScoreStore {
+public:
+    static constexpr std::size_t kMaxTail = 64;
+
+    // Opens (creating if needed) the store for `run` in `dir`. A new store
+    // first imports the old line-per-run log from the same directory
+    // (`sprint40.jsonl`, `endless.jsonl`, `blitz.jsonl`), all or nothing.
+    bool open(const std::filesystem::path& dir, RunType run);
+    bool isOpen() const { return m_open; }
+
+    bool add(const ScoreRecord& record); // durable when it returns true
+    bool compact();
+
+    std::size_t size() const { return m_indexCount + m_tail.size(); }
+
+    std::vector<ScoreRecord>   top(std::size_t k) const;
+    std::optional<ScoreRecord> best() const;
+    // Runs strictly better than `record` (its 0-based place on the board).
+    std::size_t rank(const ScoreRecord& record) const;
+    // Share of stored runs `record` beats or ties, 0..100.
+    double percentile(const ScoreRecord& record) const;
+
+    // Smaller is better. Sprint: finished runs by time, then the rest by
+    // lines; Endless / Blitz: lines, then the shorter run.
+    static std::uint64_t rankKey(const ScoreRecord& record);
+
+private:
+    struct TailEntry {
+        std::uint64_t key;
+        std::uint64_t ordinal; // record number in the data file
+        ScoreRecord   record;
+    };
+
+    bool loadData();
+    bool loadIndex();
+    bool appendRecord(const ScoreRecord& record);
+    bool create(const std::filesystem::path& legacy); // legacy: log to import, or empty
+    bool importJsonl(const std::filesystem::path& path, std::FILE* out);
+    std::optional<ScoreRecord> indexed(std::size_t i) const; // i-th best in the index
+    std::uint64_t indexKey(std::size_t i) const;
+
+    std::filesystem::path m_dataPath;
+    std::filesystem::path m_indexPath;
+    RunType       m_run  = RunType::Sprint;
+    bool          m_open = false;
+
+    MappedFile    m_data;          // remapped on compaction
+    MappedFile    m_index;
+    std::size_t   m_indexCount = 0;
+    std::uint64_t m_records    = 0; // whole records in the data file
+    std::vector<TailEntry> m_tail;  // sorted by (key, ordinal)
+};
+
+} // namespace Tetris
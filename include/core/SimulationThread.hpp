@@ -0,0 +1,92 @@
+// SimulationThread.hpp
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <thread>
+
+#include "core/MappedFile.hpp"
+#include "core/ReplayWriter.hpp"
+#include "core/SpscQueue.hpp"
+#include "core/TripleBuffer.hpp"
+#include "game/Replay.hpp"
+#include "game/Simulation.hpp"
+#include "game/Snapshot.hpp"
+
+namespace Tetris {
+
+// Runs a Simulation on its own thread at a fixed tick rate, independent of
+// how long rendering or display() take. Gameplay input goes in with post();
+// the render thread picks up the newest RenderSnapshot with latest().
+//
+// Ticks are scheduled on an absolute steady-clock grid: a late wake-up runs
+// the missed ticks back to back (up to kMaxCatchUpTicks) so game time never
+// drifts from wall time. Inputs carry their arrival time and are applied at
+// that point inside the tick, not at the tick boundary.
+//
+// Every input is also recorded, at the time it was actually applied, into a
+// replay that a ReplayWriter streams to disk in the background. A finished
+// replay can be raced: it is played back on this thread in lockstep with
+// the live run and its board rides along in each RenderSnapshot.
+class SimulationThread {
+public:
+    using clock = std::chrono::steady_clock;
+
+    static constexpr int          kTickHz  = 1000;
+    static constexpr std::int64_t kTickUs  = Simulation::kStepUs;
+    static_assert(kTickUs * kTickHz == 1'000'000);
+    static constexpr int          kMaxCatchUpTicks = 250;
+    static constexpr std::size_t  kInputCapacity   = 1024;
+
+    explicit SimulationThread(BackgroundIo& io) : m_replayOut(io) {}
+    ~SimulationThread() { stop(); }
+    SimulationThread(const SimulationThread&) = delete;
+    SimulationThread& operator=(const SimulationThread&) = delete;
+
+    // Resets the simulation for a new run and starts ticking. The replay is
+    // written to `replayPath` (nothing is recorded if it is empty); a
+    // `racePath` replay of the same run type is played alongside. A `setup`
+    // (practice boards) replaces the fresh run; it isn't reproducible from
+    // the seed, so such a run is never recorded.
+    void start(RunType run, const MoveSettings& settings, std::uint64_t seed,
+               const std::filesystem::path& replayPath = {},
+               const std::filesystem::path& racePath = {},
+               const Simulation::Checkpoint* setup = nullptr);
+    // Joins the thread; the last snapshot stays readable. A run still in
+    // progress is saved as abandoned.
+    void stop();
+    bool running() const { return m_thread.joinable(); }
+
+    // window thread. `arrived` is when the event was taken off the OS
+    // queue. Returns the input's sequence number (RenderSnapshot::inputSeq
+    // reaches it once applied), or 0 if the queue was full and it was dropped.
+    std::uint32_t post(InputAction action, bool pressed, clock::time_point arrived);
+    const RenderSnapshot& latest() { return m_snapshots.read(); }
+    std::uint32_t takeTickCount() { return m_ticks.exchange(0, std::memory_order_relaxed); }
+
+private:
+    void threadMain();
+    void publish();
+    void finishReplay();
+    void openRace();
+
+    Simulation                   m_sim;       // simulation thread only while running
+    TripleBuffer<RenderSnapshot> m_snapshots;
+    SpscQueue<InputEvent, kInputCapacity> m_inputs;
+    ReplayRecorder               m_recorder;  // simulation thread only while running
+    ReplayWriter                 m_replayOut;
+    std::filesystem::path        m_racePath;
+    MappedFile                   m_raceFile;  // simulation thread only while running
+    ReplayPlayer                 m_race;      // simulation thread only while running
+    bool                         m_racing = false;
+
+    clock::time_point          m_runStart{}; // written before the thread starts
+    std::uint32_t              m_nextSeq = 1; // window thread only
+    std::atomic<bool>          m_stop{false};
+    std::atomic<std::uint32_t> m_ticks{0};
+    std::thread                m_thread;
+};
+
+} // namespace Tetris
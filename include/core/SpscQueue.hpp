@@ -0,0 +1,67 @@
+// SpscQueue.hpp
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+
+namespace Tetris {
+
+// Bounded lock-free queue for exactly one producer thread and one consumer
+// thread. Capacity must be a power of two; one push/pop costs two atomic
+// loads and one release store. Head and tail sit on separate cache lines so
+// the two threads don't false-share.
+template <typename T, std::size_t Capacity>
+class SpscQueue {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "capacity must be a power of two");
+    static_assert(std::is_trivially_copyable_v<T>, "elements are copied without destructors");
+
+public:
+    // producer; false if full
+    bool tryPush(const T& value) {
+        const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_headCache == Capacity) {
+            m_headCache = m_head.load(std::memory_order_acquire);
+            if (tail - m_headCache == Capacity)
+                return false;
+        }
+        m_slots[tail & kMask] = value;
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // consumer; null if empty. Valid until pop().
+    const T* front() {
+        const std::size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tailCache) {
+            m_tailCache = m_tail.load(std::memory_order_acquire);
+            if (head == m_tailCache)
+                return nullptr;
+        }
+        return &m_slots[head & kMask];
+    }
+
+    // consumer; only after front() returned non-null
+    void pop() {
+        m_head.store(m_head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // consumer; drops everything currently queued
+    void clear() {
+        while (front())
+            pop();
+    }
+
+private:
+    static constexpr std::size_t kMask = Capacity - 1;
+    static constexpr std::size_t kLine = 64;
+
+    alignas(kLine) std::atomic<std::size_t> m_head{0};
+    std::size_t                             m_tailCache = 0; // consumer's view of m_tail
+    alignas(kLine) std::atomic<std::size_t> m_tail{0};
+    std::size_t                             m_headCache = 0; // producer's view of m_head
+    alignas(kLine) T                        m_slots[Capacity]{};
+};
+
+} // namespace Tetris
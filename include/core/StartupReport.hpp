@@ -0,0 +1,53 @@
+// StartupReport.hpp
+#pragma once
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Tetris {
+
+// Collects wall-clock spans of the startup phases (possibly recorded from
+// loader threads) and logs them once the first frame has been presented.
+class StartupReport {
+public:
+    using clock = std::chrono::steady_clock;
+
+    StartupReport() : m_origin(clock::now()) {}
+
+    // Record a phase that ran from `start` until `end` (thread-safe).
+    void add(std::string name, clock::time_point start, clock::time_point end);
+    void add(std::string name, clock::time_point start) { add(std::move(name), start, clock::now()); }
+
+    // Log every phase plus time-to-first-frame to stderr. Only the first call prints.
+    void print(clock::time_point firstFrame);
+
+    // RAII helper: records [construction, destruction) as one phase.
+    class Phase {
+    public:
+        Phase(StartupReport& report, const char* name)
+            : m_report(report), m_name(name), m_start(clock::now()) {}
+        ~Phase() { m_report.add(m_name, m_start); }
+        Phase(const Phase&) = delete;
+        Phase& operator=(const Phase&) = delete;
+    private:
+        StartupReport&    m_report;
+        const char*       m_name;
+        clock::time_point m_start;
+    };
+
+private:
+    struct Entry {
+        std::string       name;
+        clock::time_point start;
+        clock::time_point end;
+    };
+
+    clock::time_point  m_origin;
+    std::vector<Entry> m_entries;
+    std::mutex         m_mutex;
+    bool               m_printed = false;
+};
+
+} // namespace Tetris
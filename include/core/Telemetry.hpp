@@ -0,0 +1,105 @@
+// Telemetry.hpp
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Live per-frame metrics published to a shared-memory ring (POSIX shm under
+// /dev/shm, a named file mapping on Windows) for external monitors. The game
+// writes, readers (tools/telemetry_tail.cpp) only map and poll.
+//
+// Protocol: every slot has its own sequence word (a seqlock). The writer
+// marks the slot odd (2*index+1), stores the sample words, then publishes
+// 2*index+2 and bumps the header's writeIndex. A reader copies the words and
+// accepts the sample only if the sequence read before and after is 2*index+2.
+// The writer never waits for readers.
+
+namespace Tetris {
+
+inline constexpr char          kTelemetryMagic[8] = {'T', 'S', 'R', 'S', 'T', 'E', 'L', '\0'};
+inline constexpr std::uint32_t kTelemetryVersion  = 1;
+inline constexpr std::uint32_t kTelemetryDefaultCapacity = 1024; // frames
+
+// One frame's worth of numbers. All fields are 64-bit so the sample can be
+// copied as plain words.
+struct TelemetrySample {
+    std::uint64_t frameIndex   = 0;
+    std::uint64_t timestampNs  = 0; // steady clock
+    double        frameMs      = 0.0;
+    std::uint64_t simTicks     = 0; // simulation steps run during this frame
+    std::uint64_t inputEvents  = 0; // window events handled during this frame
+    std::uint64_t piecesPlaced = 0; // current run
+    std::uint64_t linesCleared = 0; // current run
+    std::uint64_t mode         = 0; // AppMode
+};
+inline constexpr std::size_t kTelemetryWords = sizeof(TelemetrySample) / sizeof(std::uint64_t);
+static_assert(sizeof(TelemetrySample) == kTelemetryWords * sizeof(std::uint64_t));
+
+struct TelemetrySlot {
+    std::atomic<std::uint64_t> seq;
+    std::uint64_t              words[kTelemetryWords];
+};
+
+struct TelemetryHeader {
+    char                       magic[8];
+    std::uint32_t              version;
+    std::uint32_t              capacity;   // slots following the header
+    std::uint32_t              sampleSize; // sizeof(TelemetrySample)
+    std::uint32_t              reserved;
+    std::atomic<std::uint64_t> writeIndex; // samples published so far
+};
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free,
+              "shared-memory protocol needs lock-free 64-bit atomics");
+
+inline std::size_t telemetryMappingSize(std::uint32_t capacity) {
+    return sizeof(TelemetryHeader) + std::size_t{capacity} * sizeof(TelemetrySlot);
+}
+
+inline TelemetrySlot* telemetrySlots(TelemetryHeader* h) {
+    return reinterpret_cast<TelemetrySlot*>(h + 1);
+}
+
+// Platform shared-memory segment; used by both the publisher and readers.
+class SharedMemory {
+public:
+    SharedMemory() = default;
+    ~SharedMemory() { close(); }
+    SharedMemory(const SharedMemory&) = delete;
+    SharedMemory& operator=(const SharedMemory&) = delete;
+
+    bool create(const std::string& name, std::size_t size); // read-write, owner
+    bool openReadOnly(const std::string& name);
+    void close();
+
+    void*       data()       { return m_data; }
+    std::size_t size() const { return m_size; }
+
+private:
+    void*       m_data  = nullptr;
+    std::size_t m_size  = 0;
+    bool        m_owner = false;
+    std::string m_name;
+#ifdef _WIN32
+    void* m_handle = nullptr;
+#endif
+};
+
+class TelemetryPublisher {
+public:
+    // Creates (or recreates) the named segment. Returns false if shared
+    // memory is unavailable; publish() is then a no-op.
+    bool open(const std::string& name, std::uint32_t capacity = kTelemetryDefaultCapacity);
+    bool isOpen() const { return m_header != nullptr; }
+
+    // Wait-free: a few relaxed stores and two release stores.
+    void publish(const TelemetrySample& sample);
+
+private:
+    SharedMemory     m_shm;
+    TelemetryHeader* m_header = nullptr;
+    std::uint64_t    m_next   = 0;
+};
+
+} // namespace Tetris
@@ -0,0 +1,87 @@
+// ThreadPool.hpp
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "core/Trace.hpp"
+
+namespace Tetris {
+
+// Small fixed-size worker pool for background jobs (asset decoding etc).
+// Jobs run in submission order; the destructor finishes queued jobs and joins.
+class ThreadPool {
+public:
+    explicit ThreadPool(unsigned threads = defaultThreadCount()) {
+        threads = std::max(threads, 1u);
+        m_workers.reserve(threads);
+        for (unsigned i = 0; i < threads; ++i)
+            m_workers.emplace_back([this] { workerLoop(); });
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard lock(m_mutex);
+            m_stopping = true;
+        }
+        m_cv.notify_all();
+        for (auto& t : m_workers) t.join();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    template<class F>
+    auto submit(F&& fn) -> std::future<std::invoke_result_t<std::decay_t<F>>> {
+        using R = std::invoke_result_t<std::decay_t<F>>;
+        // std::function needs a copyable target, so share the task
+        auto task = std::make_shared<std::packaged_task<R()>>(std::forward<F>(fn));
+        auto fut  = task->get_future();
+        {
+            std::lock_guard lock(m_mutex);
+            m_jobs.emplace_back([task] { (*task)(); });
+        }
+        m_cv.notify_one();
+        return fut;
+    }
+
+    std::size_t size() const { return m_workers.size(); }
+
+    static unsigned defaultThreadCount() {
+        const unsigned hw = std::thread::hardware_concurrency();
+        return hw == 0 ? 2u : hw;
+    }
+
+private:
+    void workerLoop() {
+        Trace::setThreadName("pool worker");
+        for (;;) {
+            std::function<void()> job;
+            {
+                std::unique_lock lock(m_mutex);
+                m_cv.wait(lock, [this] { return m_stopping || !m_jobs.empty(); });
+                if (m_jobs.empty())
+                    return; // stopping and drained
+                job = std::move(m_jobs.front());
+                m_jobs.pop_front();
+            }
+            job();
+        }
+    }
+
+    std::vector<std::thread>          m_workers;
+    std::deque<std::function<void()>> m_jobs;
+    std::mutex                        m_mutex;
+    std::condition_variable           m_cv;
+    bool                              m_stopping = false;
+};
+
+} // namespace Tetris
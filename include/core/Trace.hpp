@@ -0,0 +1,73 @@
+// Trace.hpp
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+// Scoped trace markers written as Chrome trace_event JSON (loads in
+// Perfetto / chrome://tracing). Off by default: a disabled TETRIS_TRACE_SCOPE
+// is one relaxed atomic load. When on, each thread appends complete ("X")
+// events to its own buffer, preallocated on the thread's first event; nothing
+// is shared or locked on the hot path, and full buffers drop new events.
+
+namespace Tetris::Trace {
+
+inline constexpr std::size_t kDefaultEventsPerThread = std::size_t{1} << 18;
+
+namespace detail {
+    inline std::atomic<bool> g_enabled{false};
+
+    inline std::int64_t nowNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void record(const char* name, const char* category, std::int64_t beginNs, std::int64_t endNs);
+} // namespace detail
+
+inline bool enabled() { return detail::g_enabled.load(std::memory_order_relaxed); }
+
+// Turn tracing on; flush() will write to `outputPath`. The calling thread's
+// buffer is allocated right away.
+void start(const std::filesystem::path& outputPath,
+           std::size_t eventsPerThread = kDefaultEventsPerThread);
+
+// Write everything recorded so far (all threads) to the start() path.
+// Safe to call repeatedly while recording; each call rewrites the file.
+bool flush();
+
+// Label the calling thread in the trace viewer. No-op when tracing is off.
+void setThreadName(const char* name);
+
+class Scope {
+public:
+    explicit Scope(const char* name, const char* category = "app")
+        : m_name(enabled() ? name : nullptr)
+        , m_category(category)
+        , m_begin(m_name ? detail::nowNs() : 0) {}
+
+    ~Scope() {
+        if (m_name)
+            detail::record(m_name, m_category, m_begin, detail::nowNs());
+    }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+private:
+    const char*  m_name;     // must be a string literal (stored by pointer)
+    const char*  m_category;
+    std::int64_t m_begin;
+};
+
+} // namespace Tetris::Trace
+
+#define TETRIS_TRACE_CONCAT_(a, b) a##b
+#define TETRIS_TRACE_CONCAT(a, b)  TETRIS_TRACE_CONCAT_(a, b)
+#define TETRIS_TRACE_SCOPE(name) \
+    ::Tetris::Trace::Scope TETRIS_TRACE_CONCAT(tetrisTraceScope_, __LINE__)(name)
+#define TETRIS_TRACE_SCOPE_CAT(name, category) \
+    ::Tetris::Trace::Scope TETRIS_TRACE_CONCAT(tetrisTraceScope_, __LINE__)(name, category)
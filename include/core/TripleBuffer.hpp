@@ -0,0 +1,49 @@
+// TripleBuffer.hpp
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace Tetris {
+
+// Single-writer / single-reader latest-value channel. The writer fills
+// back(), then publish() swaps it with the shared middle slot; the reader's
+// read() swaps the middle slot into front() if something new arrived. Neither
+// side ever waits: the writer may publish many times between reads (only the
+// newest survives), the reader may re-read the same value.
+template <typename T>
+class TripleBuffer {
+public:
+    // writer side
+    T& back() { return m_slots[m_back]; }
+
+    void publish() {
+        const std::uint8_t prev = m_middle.exchange(static_cast<std::uint8_t>(m_back | kFresh),
+                                                    std::memory_order_acq_rel);
+        m_back = prev & kIndexMask;
+    }
+
+    // reader side; returns the newest published value
+    const T& read() {
+        if (m_middle.load(std::memory_order_relaxed) & kFresh) {
+            const std::uint8_t prev = m_middle.exchange(m_front, std::memory_order_acq_rel);
+            m_front = prev & kIndexMask;
+        }
+        return m_slots[m_front];
+    }
+
+    // true if publish() happened since the last read()
+    bool fresh() const { return (m_middle.load(std::memory_order_relaxed) & kFresh) != 0; }
+
+private:
+    static constexpr std::uint8_t kFresh     = 0x4;
+    static constexpr std::uint8_t kIndexMask = 0x3;
+
+    std::array<T, 3>          m_slots{};
+    std::uint8_t              m_back  = 0; // writer only
+    std::uint8_t              m_front = 1; // reader only
+    std::atomic<std::uint8_t> m_middle{2};
+};
+
+} // namespace Tetris
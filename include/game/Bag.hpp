@@ -1,24 +1,96 @@
 #pragma once
 #include "Pieces.hpp"
 #include "GameState.hpp"
+#include <algorithm>
 #include <array>
+#include <cstdint>
 #include <random>
-#include <algorithm>
+#include <span>
+#include <utility>
 
 namespace Tetris {
 
+// SplitMix64: tiny, fast, and the same sequence on every compiler and
+// standard library (std::mt19937 is, std::shuffle is not), so a seed fully
+// determines the piece order -- replays depend on that.
+class BagRng {
+public:
+    explicit BagRng(std::uint64_t seed = 0) : m_state(seed) {}
+
+    std::uint64_t next() {
+        std::uint64_t z = (m_state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    // unbiased value in [0, n), n > 0
+    std::uint32_t below(std::uint32_t n) {
+        const std::uint64_t limit = (~std::uint64_t{0}) - (~std::uint64_t{0}) % n;
+        std::uint64_t r;
+        do { r = next(); } while (r >= limit);
+        return static_cast<std::uint32_t>(r % n);
+    }
+
+    std::uint64_t state() const { return m_state; }
+
+private:
+    std::uint64_t m_state;
+};
+
 class SevenBag {
 public:
-    SevenBag() : rng(std::random_device{}()) { refill(); }
-    Tetromino next() { if (pos >= bag.size()) refill(); return bag[pos++]; }
+    SevenBag() : SevenBag((std::uint64_t{std::random_device{}()} << 32) ^ std::random_device{}()) {}
+    explicit SevenBag(std::uint64_t seed) : rng(seed) { refill(bag); refill(nextBag); }
+
+    Tetromino next() {
+        if (pos >= bag.size()) { bag = nextBag; refill(nextBag); pos = 0; }
+        return bag[pos++];
+    }
+    // Look i pieces ahead without drawing. The following bag is shuffled
+    // eagerly, so any i < 7 is answered without copying the rng.
+    Tetromino peek(std::size_t i) const {
+        const std::size_t idx = pos + i;
+        return idx < bag.size() ? bag[idx] : nextBag[idx - bag.size()];
+    }
+
+    // Deal `queue` (at most 14 pieces, the rest is ignored) before anything
+    // else; shuffled bags follow it. Practice boards set their queue this way,
+    // and it stays part of save() like any other bag state.
+    void preload(std::span<const Tetromino> queue) {
+        const std::size_t n = std::min(queue.size(), bag.size() + nextBag.size());
+        if (n == 0)
+            return;
+        pos = bag.size() + nextBag.size() - n;
+        if (pos >= bag.size()) { // fits in one bag: the current one ends with it
+            pos -= bag.size();
+            std::copy_n(queue.begin(), n, bag.begin() + static_cast<std::ptrdiff_t>(pos));
+        } else {
+            const std::size_t first = bag.size() - pos;
+            std::copy_n(queue.begin(), first, bag.begin() + static_cast<std::ptrdiff_t>(pos));
+            std::copy_n(queue.begin() + static_cast<std::ptrdiff_t>(first), nextBag.size(), nextBag.begin());
+        }
+    }
+
+    // Complete shuffle state (replay keyframes).
+    struct Saved {
+        std::uint64_t rng = 0;
+        std::array<Tetromino,7> bag{};
+        std::array<Tetromino,7> nextBag{};
+        std::uint8_t pos = 0;
+    };
+    Saved save() const { return {rng.state(), bag, nextBag, static_cast<std::uint8_t>(pos)}; }
+    void restore(const Saved& s) { rng = BagRng(s.rng); bag = s.bag; nextBag = s.nextBag; pos = s.pos; }
 private:
-    void refill() {
-        bag = {Tetromino::I, Tetromino::J, Tetromino::L, Tetromino::O, Tetromino::S, Tetromino::T, Tetromino::Z};
-        std::shuffle(bag.begin(), bag.end(), rng);
-        pos = 0;
+    void refill(std::array<Tetromino,7>& b) {
+        b = {Tetromino::I, Tetromino::J, Tetromino::L, Tetromino::O, Tetromino::S, Tetromino::T, Tetromino::Z};
+        // Fisher-Yates
+        for (std::uint32_t i = 6; i > 0; --i)
+            std::swap(b[i], b[rng.below(i + 1)]);
     }
-    std::mt19937 rng;
+    BagRng rng;
     std::array<Tetromino,7> bag{};
+    std::array<Tetromino,7> nextBag{};
     std::size_t pos = 0;
 };
 
@@ -0,0 +1,93 @@
+// Fumen.hpp
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "game/GameState.hpp"
+
+namespace Tetris {
+
+// Fumen (v115), the board-diagram strings players share setups with:
+//
+//   "v115@" + base64 (A-Za-z0-9+/, little-endian digits), per page
+//     field   runs of (cell diff against the previous page + 8) * 240 + (len - 1),
+//             2 digits each; a page that changes nothing is followed by one
+//             digit counting how many more pages also change nothing
+//     action  3 digits: piece, rotation, location, then the lock / comment /
+//             colorize / mirror / rise flags
+//     comment (if flagged) 2 digits length, then 4 characters per 5 digits,
+//             JS escape()d; a page without one inherits the previous page's
+//
+// The field is 23 rows plus a garbage row under them that a `rise` page
+// pushes up. A locked piece is placed, full rows are cleared and rise /
+// mirror applied before the next page's diff, so decoder and encoder both
+// replay that. A "#Q=[H](C)NEXT" comment is a quiz: hold, current piece and
+// queue, advanced automatically as locked pages use them up.
+inline constexpr int kFumenWidth   = 10;
+inline constexpr int kFumenHeight  = 23;                               // rows above the garbage row
+inline constexpr int kFumenCells   = kFumenWidth * (kFumenHeight + 1); // 240
+inline constexpr int kFumenQuizMax = 64;                               // queue pieces kept from a quiz
+
+enum class FumenPiece : std::uint8_t { Empty, I, L, O, Z, T, J, S, Gray };
+
+// cell (x, y) of FumenPage::field: y = 0 is the floor, y = -1 the garbage row
+inline constexpr int fumenIndex(int x, int y) { return (kFumenHeight - 1 - y) * kFumenWidth + x; }
+
+struct FumenPage {
+    std::array<FumenPiece, kFumenCells> field{}; // top row first, garbage row last
+
+    FumenPiece   piece    = FumenPiece::Empty; // the page's piece, Empty = none
+    std::uint8_t rotation = 0;   // ActivePiece::rot order: 0 spawn, 1 CW, 2 180, 3 CCW
+    std::int8_t  x = 0, y = 0;   // fumen's piece centre, y up from the floor
+    bool lock     = true;        // place it (and clear lines) before the next page
+    bool rise     = false;       // then push the garbage row up
+    bool mirror   = false;       // then mirror the field
+    bool colorize = true;
+    std::string comment;
+};
+
+struct FumenQuiz {
+    FumenPiece hold    = FumenPiece::Empty;
+    FumenPiece current = FumenPiece::Empty;
+    std::array<FumenPiece, kFumenQuizMax> next{};
+    int        count   = 0;      // pieces in `next`
+};
+
+// Any "v115@..." string, also with the '?' line breaks fumen inserts or a
+// whole "https://...?v115@..." link. `pages` is overwritten (its strings are
+// reused, so decoding many fumens into one vector doesn't allocate).
+// false: not v115 or malformed.
+bool decodeFumen(std::string_view text, std::vector<FumenPage>& pages);
+// Appends "v115@..." to `out`. A comment is only written on pages where it
+// differs from the one the page would inherit. Pieces that don't fit the
+// field are left out.
+void encodeFumen(std::span<const FumenPage> pages, std::string& out);
+
+// Absolute cells of the page's piece. false if it has none or any cell is
+// outside the 10x23 field.
+bool fumenPieceCells(const FumenPage& page, std::array<std::array<int, 2>, 4>& cells);
+
+bool parseFumenQuiz(std::string_view comment, FumenQuiz& out); // false: not a quiz
+void formatFumenQuiz(const FumenQuiz& quiz, std::string& out);  // "#Q=[H](C)NEXT"
+// The quiz after `used` was placed from it (current, hold, or hold-then-next).
+// false: `used` wasn't available, the quiz is unchanged.
+bool advanceFumenQuiz(FumenQuiz& quiz, FumenPiece used);
+
+// Sets up `s`, a freshly reset run, as the page shows it: the board, the
+// page's piece (else the quiz's current piece) as the active piece, and the
+// quiz's hold and queue (the first 14 pieces; shuffled bags follow). The
+// top row and the garbage row have no place in the 22-row grid and are
+// dropped. false: the page doesn't fit (cells above the grid, or the piece
+// overlaps the board) -- `s` is still playable.
+bool fumenToState(const FumenPage& page, GameState& s);
+// One page showing `s`: the board, the active piece (not locked) and a quiz
+// comment with the hold piece and the next kFumenQuizPreview pieces.
+inline constexpr int kFumenQuizPreview = 5;
+void stateToFumen(const GameState& s, FumenPage& page);
+
+} // namespace Tetris
@@ -20,18 +20,28 @@ enum class RunType {
     Blitz
 };
 
+// lower-case name used in file names and tools
+inline const char* runTypeName(RunType run) {
+    switch (run) {
+        case RunType::Sprint: return "sprint";
+        case RunType::Blitz:  return "blitz";
+        default:              return "endless";
+    }
+}
+
 struct GameState {
     std::array<Cell, COLS * ROWS> grid{};
 
     // falling / lock
     SevenBag   bag;
     ActivePiece active;
-    float gravity    = 1.0f;  // cells per second
-    float fallAcc    = 0.f;
+    std::int64_t rowIntervalUs = 1'000'000; // gravity: time per row
+    std::int64_t fallAccUs     = 0;
+    int          level         = 1;         // Endless speed level
 
     // lock delay
-    float lockDelay  = 0.5f;  // seconds
-    float lockTimer  = 0.f;
+    std::int64_t lockDelayUs = 500'000;
+    std::int64_t lockTimerUs = 0;
     int   lockResets = 0;
     int   maxLockResets = 15;
     bool  grounded   = false;
@@ -46,12 +56,13 @@ struct GameState {
 
     // shared scoring / state
     int  totalLinesCleared  = 0;
+    int  piecesPlaced       = 0;
     bool gameOver           = false;
 
     // sprint-specific
     int   sprintTargetLines   = 40;
     bool  sprintCompleted     = false;
-    float sprintTime          = 0.f;
+    std::int64_t sprintTimeUs = 0;
     bool  sprintTimerRunning  = false;
 };
 
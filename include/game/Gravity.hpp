@@ -0,0 +1,43 @@
+// Gravity.hpp
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+#include "game/GameState.hpp"
+
+namespace Tetris {
+
+constexpr int kLinesPerLevel   = 10;
+// Level cap. The curve below already reaches 20G (<= kInstantRowUs) at
+// level 19, 0.674^18 s = 824 us; 20 is the guideline's last level and is
+// pinned to kInstantRowUs.
+constexpr int kMaxGravityLevel = 20;
+
+// Row interval at or below which gravity counts as 20G: a whole visible
+// board's worth of rows per 60 Hz frame. The piece then never hangs in the
+// air and is placed on the ground in one step.
+constexpr std::int64_t kInstantRowUs = 1'000'000 / (60 * VISIBLE_ROWS);
+
+inline int endlessLevel(int totalLinesCleared) {
+    return std::min(1 + totalLinesCleared / kLinesPerLevel, kMaxGravityLevel);
+}
+
+// Guideline speed curve, (0.8 - (level - 1) * 0.007)^(level - 1) seconds per
+// row, in whole microseconds. Level 1 is 1 row/s.
+inline std::int64_t rowIntervalUsForLevel(int level) {
+    static const auto table = [] {
+        std::array<std::int64_t, kMaxGravityLevel + 1> t{};
+        for (int l = 1; l < kMaxGravityLevel; ++l) {
+            const double seconds = std::pow(0.8 - (l - 1) * 0.007, l - 1);
+            t[l] = std::max<std::int64_t>(1, std::llround(seconds * 1e6));
+        }
+        t[kMaxGravityLevel] = kInstantRowUs;
+        return t;
+    }();
+    return table[static_cast<std::size_t>(std::clamp(level, 1, kMaxGravityLevel))];
+}
+
+} // namespace Tetris
@@ -31,6 +31,7 @@ inline void lockPiece(GameState& s) {
         const int gy = s.active.y + c[1];
         if (inBounds(gx, gy)) s.grid[gy * COLS + gx] = val;
     }
+    ++s.piecesPlaced;
 }
 
 inline int clearLines(GameState& s)
@@ -103,7 +104,7 @@ inline void spawnActive(GameState& s, Tetromino t) {
     s.active = makeSpawnPiece(t);
 
     s.grounded   = false;
-    s.lockTimer  = 0.f;
+    s.lockTimerUs = 0;
     s.lockResets = 0;
 }
 
@@ -151,16 +152,32 @@ inline bool canMove(const GameState& s, const ActivePiece& p, int dx, int dy) {
     return !blocked(s, q);
 }
 
+// How many whole cells piece `p` can travel in direction (dx, dy) -- a unit
+// step along one axis -- before a wall, the floor or the stack stops it.
+// One short scan per mino instead of a blocked() test per cell travelled.
+inline int distanceToObstruction(const GameState& s, const ActivePiece& p, int dx, int dy) {
+    const auto& sh = shape(p.type).cells[p.rot];
+    int best = std::max(COLS, ROWS);
+    for (const auto& c : sh) {
+        int x = p.x + c[0];
+        int y = p.y + c[1];
+        int d = 0;
+        while (d < best) {
+            x += dx;
+            y += dy;
+            if (!inBounds(x, y) || s.grid[y * COLS + x] != 0)
+                break;
+            ++d;
+        }
+        best = std::min(best, d);
+    }
+    return best;
+}
+
 // Compute where the active piece would land if dropped straight down.
 inline ActivePiece dropToGround(const GameState& s) {
     ActivePiece g = s.active;
-    while (true) {
-        ActivePiece next = g;
-        next.y -= 1;                 // down is -1 in your system
-        if (blocked(s, next))        // would collide: stop
-            break;
-        g = next;
-    }
+    g.y -= distanceToObstruction(s, g, 0, -1); // down is -1 in your system
     return g;
 }
 
@@ -168,10 +185,10 @@ inline ActivePiece dropToGround(const GameState& s) {
 // This lets HUD treat the bag "like a queue" safely.
 template<std::size_t N>
 inline std::array<Tetromino, N> peekNextPieces(const GameState& s) {
-    auto bagCopy = s.bag;                // copy the bag, not the whole state
+    static_assert(N <= 7, "bag lookahead is one full bag");
     std::array<Tetromino, N> out{};
     for (std::size_t i = 0; i < N; ++i) {
-        out[i] = bagCopy.next();
+        out[i] = s.bag.peek(i);
     }
     return out;
 }
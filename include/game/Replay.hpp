@@ -0,0 +1,164 @@
+// Replay.hpp
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "game/GameState.hpp"
+#include "game/Simulation.hpp"
+
+namespace Tetris {
+
+// Binary replay of one run: enough to rebuild it exactly with Simulation.
+//
+//   header (40 bytes, little-endian)
+//     magic "TSRSRPL\0", u16 version, u8 runType, u8 reserved,
+//     f32 das, f32 arr, f32 sdf (raw IEEE bits), u64 seed, i64 started (unix s)
+//   records, each starting with varint (deltaUs << 4 | code)
+//     code 0..7   InputAction pressed
+//     code 8..10  Left / Right / SoftDrop released (other releases do nothing)
+//     code 14     keyframe: varint size, packed Simulation::Checkpoint
+//     code 15     end: then varint lines, pieces, sprintTimeUs, u8 flags
+//   index (version 2): count x ReplayKeyframe, then the 24-byte trailer
+//     u64 indexOffset, u32 count, u32 entrySize, magic "TSRSIDX\0"
+//
+// deltaUs is the time since the previous record on the simulation clock,
+// i.e. exactly where Simulation::apply() ran. Keyframes are taken every
+// kKeyframePieces pieces, so seeking only ever re-simulates a few pieces.
+// Version 1 files (no keyframes, no index) still play; they just seek from
+// the start.
+inline constexpr char          kReplayMagic[8]      = {'T', 'S', 'R', 'S', 'R', 'P', 'L', '\0'};
+inline constexpr char          kReplayIndexMagic[8] = {'T', 'S', 'R', 'S', 'I', 'D', 'X', '\0'};
+inline constexpr std::uint16_t kReplayVersion       = 2;
+inline constexpr std::size_t   kReplayHeaderSize    = 40;
+inline constexpr std::size_t   kReplayTrailerSize   = 24;
+inline constexpr std::size_t   kReplayIndexEntrySize = 32;
+inline constexpr int           kKeyframePieces      = 50;
+
+struct ReplayHeader {
+    RunType       runType  = RunType::Endless;
+    MoveSettings  settings{};
+    std::uint64_t seed     = 0;
+    std::int64_t  startedUnix = 0;
+};
+
+struct ReplayResult {
+    std::int64_t  endTimeUs    = 0;
+    std::uint32_t lines        = 0;
+    std::uint32_t pieces       = 0;
+    std::int64_t  sprintTimeUs = 0;
+    bool          gameOver     = false; // false: abandoned (Esc) before the end
+};
+
+// One index entry: u32 pieces, u32 size, i64 timeUs, u64 offset, u64 resume
+struct ReplayKeyframe {
+    std::uint32_t pieces = 0;       // pieces placed when it was taken
+    std::uint32_t size   = 0;       // packed checkpoint bytes
+    std::int64_t  timeUs = 0;       // simulation time
+    std::uint64_t offset = 0;       // file offset of the packed checkpoint
+    std::uint64_t resume = 0;       // file offset of the record after it
+};
+
+void packCheckpoint(const Simulation::Checkpoint& cp, std::vector<std::uint8_t>& out);
+bool unpackCheckpoint(std::span<const std::uint8_t> bytes, Simulation::Checkpoint& out);
+
+// Builds the byte stream. Used on the simulation thread, so it only appends
+// to memory; takeChunk() hands finished bytes to whoever writes the file.
+class ReplayRecorder {
+public:
+    void begin(const ReplayHeader& header);
+    void record(const InputEvent& in);   // ignores inputs that change nothing
+    void keyframeIfDue(const Simulation& sim);
+    void end(const ReplayResult& result); // end record + keyframe index
+
+    bool active() const { return m_active; }
+    std::size_t pending() const { return m_buf.size(); }
+    std::vector<std::uint8_t> takeChunk();
+
+private:
+    std::uint64_t offset() const { return m_flushed + m_buf.size(); }
+
+    std::vector<std::uint8_t>   m_buf;
+    std::vector<std::uint8_t>   m_packed; // scratch for keyframes
+    std::vector<ReplayKeyframe> m_index;
+    std::uint64_t m_flushed = 0;         // bytes already handed out
+    std::int64_t  m_lastUs  = 0;
+    int           m_nextKeyframe = kKeyframePieces;
+    bool          m_active  = false;
+};
+
+// Incremental reader over a whole replay in memory (normally a MappedFile,
+// so only the pages actually decoded are ever read from disk).
+class ReplayDecoder {
+public:
+    // false if the header is missing / not a replay / unknown version
+    bool open(std::span<const std::uint8_t> bytes);
+
+    const ReplayHeader& header() const { return m_header; }
+    std::uint16_t       version() const { return m_version; }
+    std::span<const std::uint8_t> bytes() const { return m_bytes; }
+
+    // From the index footer; empty for version 1 or an unfinished file.
+    const std::vector<ReplayKeyframe>& keyframes() const { return m_keyframes; }
+
+    // Next input in order, skipping keyframe records. false at the end
+    // record (result() is then valid) or if the stream is truncated /
+    // corrupt (error() is set).
+    bool next(InputEvent& out);
+
+    // Continue decoding right after keyframe `kf` (see ReplayPlayer::seek).
+    void resumeAt(const ReplayKeyframe& kf);
+
+    bool                finished() const { return m_finished; }
+    bool                error() const    { return m_error; }
+    const ReplayResult& result() const   { return m_result; }
+
+private:
+    bool readVarint(std::uint64_t& out);
+    void readIndex();
+
+    std::span<const std::uint8_t> m_bytes;
+    std::size_t   m_pos     = 0;
+    std::size_t   m_end     = 0; // end of the record stream
+    std::int64_t  m_timeUs  = 0;
+    std::uint16_t m_version = 0;
+    ReplayHeader  m_header;
+    ReplayResult  m_result;
+    std::vector<ReplayKeyframe> m_keyframes;
+    bool m_finished = false;
+    bool m_error    = false;
+};
+
+// Plays a replay back through a Simulation: the same rules the game ran,
+// driven by the recorded inputs instead of a keyboard. Inputs stamped at or
+// before a time are applied when advancing to it, like the live tick loop.
+class ReplayPlayer {
+public:
+    bool open(std::span<const std::uint8_t> bytes); // false: not a replay
+
+    void advanceTo(std::int64_t timeUs);
+    // Through the end record (or to the last readable input if the stream
+    // is truncated -- decoder().error() tells).
+    void runToEnd();
+
+    // Jump to any point, forwards or backwards: restores the nearest
+    // keyframe at or before it and simulates only the rest.
+    void seek(std::int64_t timeUs);
+    void seekToPiece(int pieces); // first moment `pieces` pieces are placed
+
+    const Simulation&    sim() const     { return m_sim; }
+    const ReplayDecoder& decoder() const { return m_decoder; }
+
+private:
+    // restore the keyframe (nullptr: the start of the run)
+    void restart(const ReplayKeyframe* kf);
+
+    ReplayDecoder m_decoder;
+    Simulation    m_sim;
+    InputEvent    m_pending;
+    bool          m_hasPending = false;
+};
+
+} // namespace Tetris
@@ -0,0 +1,109 @@
+// Simulation.hpp
+#pragma once
+
+#include <cstdint>
+
+#include "game/GameState.hpp"
+#include "game/Snapshot.hpp"
+
+namespace Tetris {
+
+// Soft-drop factor at or above this means instant soft drop.
+constexpr float kSdfInstant = 41.f;
+
+struct MoveSettings {
+    float das = 0.16f;   // seconds
+    float arr = 0.033f;  // seconds; 0 = instant (slide to the wall)
+    float sdf = 6.f;     // soft drop speed as a multiple of gravity
+};
+
+// Auto-shift is computed from the key-down time rather than accumulated per
+// tick: auto shift k (k >= 1) is due at pressUs + DAS + (k - 1) * ARR.
+struct MoveKeyState {
+    bool         held    = false;
+    std::int64_t pressUs = 0; // simulation time of key-down
+    std::int64_t shifts  = 0; // auto shifts already applied
+};
+
+// Gameplay actions, already mapped from keys by the window thread.
+enum class InputAction : std::uint8_t {
+    Left,
+    Right,
+    SoftDrop,
+    HardDrop,
+    RotateCW,
+    RotateCCW,
+    Rotate180,
+    Hold
+};
+
+struct InputEvent {
+    InputAction  action  = InputAction::Left;
+    bool         pressed = true; // false = key released
+    std::int64_t timeUs  = 0;    // arrival time, microseconds since the run started
+    std::uint32_t seq    = 0;    // increasing per posted input (LatencyProbe)
+};
+
+// Rules for one run: gameplay input, auto-shift, gravity and lock delay.
+// Owns the GameState; the renderers only ever see RenderSnapshots of it.
+// Not thread-safe: exactly one thread drives a Simulation at a time.
+class Simulation {
+public:
+    // Internal step grid. advanceTo() always stops on multiples of it (and
+    // at auto-shift instants), so the result depends only on the input
+    // times, never on how the caller slices time -- a replay fed back with
+    // one advanceTo() per input ends up in exactly the same state.
+    static constexpr std::int64_t kStepUs = 1000;
+
+    // `seed` fixes the piece order (see SevenBag).
+    void reset(RunType run, const MoveSettings& settings, std::uint64_t seed);
+
+    // Runs the rules forward to `timeUs` (no-op if already there), stopping
+    // at every grid point and auto-shift instant on the way. apply() acts
+    // at timeUs().
+    void advanceTo(std::int64_t timeUs);
+    void apply(const InputEvent& in);
+
+    std::int64_t timeUs() const { return m_timeUs; }
+
+    void snapshot(RenderSnapshot& out) const;
+
+    // Everything needed to resume a run exactly (replay keyframes).
+    // restore() keeps the MoveSettings given to reset().
+    struct Checkpoint {
+        GameState    state;
+        MoveKeyState left;
+        MoveKeyState right;
+        bool         softDropHeld = false;
+        std::int64_t timeUs       = 0;
+    };
+    Checkpoint checkpoint() const;
+    void       restore(const Checkpoint& cp);
+
+    const GameState&    state() const    { return m_state; }
+    const MoveSettings& settings() const { return m_settings; }
+
+private:
+    void step(std::int64_t dtUs);
+    std::int64_t currentRowIntervalUs() const; // gravity incl. soft drop
+    void settle();       // 20G / instant soft drop: keep the piece on the ground
+    void lockAndSpawn(); // lock, clear, next piece (or top out)
+    std::int64_t nextShiftUs(const MoveKeyState& st) const; // INT64_MAX if none
+    void applyDueShifts(MoveKeyState& st, int dir);
+    bool shiftBy(int dir, int cells); // up to `cells`, stops at obstructions
+    void sonicDrop();                 // to the ground, no lock
+    void lockResetAfterMove(); // moves / rotations on the ground reset lock delay
+    void hardDrop();
+
+    GameState    m_state;
+    MoveSettings m_settings;
+    std::int64_t m_dasUs = 0;
+    std::int64_t m_arrUs = 0;
+    MoveKeyState m_leftState;
+    MoveKeyState m_rightState;
+    bool         m_softDropHeld = false;
+    std::int64_t  m_timeUs   = 0;
+    std::uint32_t m_inputSeq = 0; // newest input applied
+};
+
+} // namespace Tetris
@@ -0,0 +1,85 @@
+// Snapshot.hpp
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "game/GameState.hpp"
+#include "game/Logic.hpp"
+
+namespace Tetris {
+
+constexpr std::size_t kSnapshotNext = 5; // queue entries the HUD can show
+
+// The personal-best run replayed next to a Sprint (ghost race), in
+// lockstep with the live game.
+struct RaceSnapshot {
+    bool shown = false;
+    std::array<Cell, COLS * ROWS> grid{};
+    ActivePiece active{};
+    int   totalLinesCleared = 0;
+    bool  finished          = false;
+    float sprintTime        = 0.f; // seconds
+};
+
+// Immutable copy of everything the renderers need from a GameState. The
+// simulation thread fills one per tick; the render thread only ever reads
+// these, never the live state.
+struct RenderSnapshot {
+    std::array<Cell, COLS * ROWS> grid{};
+
+    ActivePiece active{};
+    ActivePiece ghost{};   // where a hard drop would land
+
+    bool      hasHold  = false;
+    Tetromino holdType{};
+    std::array<Tetromino, kSnapshotNext> next{};
+
+    RunType runType           = RunType::Endless;
+    int     totalLinesCleared = 0;
+    int     piecesPlaced      = 0;
+    int     level             = 1;
+    bool    gameOver          = false;
+    bool    sprintCompleted   = false;
+    float   sprintTime        = 0.f; // seconds
+    std::int64_t sprintTimeUs = 0;   // exact, for the score store
+
+    RaceSnapshot race; // shown only while racing a PB replay
+
+    std::int64_t  timeUs   = 0; // simulation time this was taken at
+    std::uint32_t inputSeq = 0; // InputEvent::seq of the newest input applied
+};
+
+inline void fillSnapshot(const GameState& s, RenderSnapshot& out) {
+    out.grid              = s.grid;
+    out.active            = s.active;
+    out.ghost             = dropToGround(s);
+    out.hasHold           = s.hasHold;
+    out.holdType          = s.holdType;
+    out.next              = peekNextPieces<kSnapshotNext>(s);
+    out.runType           = s.runType;
+    out.totalLinesCleared = s.totalLinesCleared;
+    out.piecesPlaced      = s.piecesPlaced;
+    out.level             = s.level;
+    out.gameOver          = s.gameOver;
+    out.sprintCompleted   = s.sprintCompleted;
+    out.sprintTime        = static_cast<float>(s.sprintTimeUs) * 1e-6f;
+    out.sprintTimeUs      = s.sprintTimeUs;
+}
+
+inline void fillRaceSnapshot(const GameState& s, RaceSnapshot& out) {
+    out.shown             = true;
+    out.grid              = s.grid;
+    out.active            = s.active;
+    out.totalLinesCleared = s.totalLinesCleared;
+    out.finished          = s.gameOver;
+    out.sprintTime        = static_cast<float>(s.sprintTimeUs) * 1e-6f;
+}
+
+inline RenderSnapshot makeSnapshot(const GameState& s) {
+    RenderSnapshot out;
+    fillSnapshot(s, out);
+    return out;
+}
+
+} // namespace Tetris
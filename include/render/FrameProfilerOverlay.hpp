@@ -0,0 +1,48 @@
+// FrameProfilerOverlay.hpp
+#pragma once
+
+#include <memory>
+
+#include <SFML/Graphics/Font.hpp>
+#include <SFML/Graphics/RectangleShape.hpp>
+#include <SFML/Graphics/Text.hpp>
+#include <SFML/Graphics/VertexArray.hpp>
+
+#include "core/FrameProfiler.hpp"
+#include "render/InstrumentedTarget.hpp"
+
+namespace Tetris {
+
+// Toggleable overlay: p50 / p99 / max per frame phase and a graph of the
+// most recent frame times with 240 Hz and 60 Hz reference lines.
+class FrameProfilerOverlay {
+public:
+    FrameProfilerOverlay(InstrumentedTarget& target, const FrameProfiler& profiler);
+
+    void setFont(const sf::Font& font);
+
+    void toggle() { m_visible = !m_visible; m_textAccum = kTextInterval; }
+    bool visible() const { return m_visible; }
+
+    void update(float dt);
+    void draw();
+
+private:
+    static constexpr float kTextInterval = 0.25f; // s between table refreshes
+
+    void rebuildText();
+    void rebuildGraph();
+
+    InstrumentedTarget&  m_target;
+    const FrameProfiler& m_profiler;
+
+    std::unique_ptr<sf::Text> m_text;
+    sf::RectangleShape        m_panel;
+    sf::VertexArray           m_graph{sf::PrimitiveType::LineStrip, FrameProfiler::kGraphFrames};
+    sf::VertexArray           m_refLines{sf::PrimitiveType::Lines, 4};
+
+    bool  m_visible   = false;
+    float m_textAccum = 0.f;
+};
+
+} // namespace Tetris
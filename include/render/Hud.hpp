@@ -1,30 +1,48 @@
 #pragma once
 
+#include <array>
 #include <memory>
+#include <string>
 
-#include <SFML/Graphics/RenderWindow.hpp>
 #include <SFML/Graphics/Font.hpp>
 #include <SFML/Graphics/Text.hpp>
+#include <SFML/Graphics/VertexArray.hpp>
+
+#include "game/Pieces.hpp"
+#include "render/InstrumentedTarget.hpp"
 
 namespace Tetris {
 
-struct GameState; // from game/GameState.hpp
+struct RenderSnapshot; // from game/Snapshot.hpp
+
+// One tetromino laid out inside a preview slot: 4 cells x 2 triangles,
+// positioned relative to the slot's top-left corner.
+using MiniPieceMesh = std::array<sf::Vertex, 24>;
+using MiniPieceSet  = std::array<MiniPieceMesh, 7>; // indexed by Tetromino
 
 class Hud {
 public:
-    explicit Hud(sf::RenderWindow& window);
+    explicit Hud(InstrumentedTarget& target);
+
+    // Text overlays stay hidden until a font is provided. The font is owned
+    // by the caller and must outlive the Hud.
+    void setFont(const sf::Font& font);
+
+    // Extra diagnostic lines drawn bottom-left (empty = hidden).
+    void setDiagnostics(const std::string& text);
 
     void update(float dt);
-    void draw(const GameState& state);
+    void draw(const RenderSnapshot& state);
+
+    static constexpr int kNextShown = 5; // at most kSnapshotNext
 
 private:
-    void drawHold(const GameState& state);
-    void drawNext(const GameState& state);
+    // rebuilds m_previewVerts only when hold / queue / window width changed
+    void updatePreview(const RenderSnapshot& state);
 
-    sf::RenderWindow& m_window;
+    InstrumentedTarget& m_target;
 
-    sf::Font m_font;
-    bool     m_fontOk = false;
+    bool m_fontOk = false;
 
     float m_accum  = 0.f;
     int   m_frames = 0;
@@ -36,6 +54,20 @@ private:
     std::unique_ptr<sf::Text> m_linesText;   // "Lines: X"
     std::unique_ptr<sf::Text> m_sprintText;  // "SPRINT 40"
     std::unique_ptr<sf::Text> m_sprintInfo;  // time + finished
+
+    std::unique_ptr<sf::Text> m_diagText;    // e.g. --latency summary
+    bool m_diagShown = false;
+
+    // hold + next panels: meshes built once, batched into one vertex array
+    MiniPieceSet    m_holdMeshes{};
+    MiniPieceSet    m_nextMeshes{};
+    sf::VertexArray m_previewVerts{sf::PrimitiveType::Triangles};
+
+    bool      m_previewValid = false;
+    bool      m_shownHasHold = false;
+    Tetromino m_shownHold{};
+    std::array<Tetromino, kNextShown> m_shownNext{};
+    unsigned  m_shownWinW = 0;
 };
 
 } // namespace Tetris
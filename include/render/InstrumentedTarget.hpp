@@ -0,0 +1,190 @@
+// InstrumentedTarget.hpp
+#pragma once
+
+#include <SFML/Graphics/Font.hpp>
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/Shape.hpp>
+#include <SFML/Graphics/Sprite.hpp>
+#include <SFML/Graphics/Text.hpp>
+#include <SFML/Graphics/VertexArray.hpp>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// TETRIS_RENDER_STATS enables the per-frame counters (CMake turns it on for
+// Debug builds or with -DTETRIS_RENDER_STATS=ON). Without it the wrapper only
+// forwards to the real target and every counting statement is compiled out.
+
+namespace Tetris {
+
+// Who issued the draw; "Other" catches work done outside any scope
+// (e.g. slider text updated from input handling).
+enum class RenderSubsystem : std::uint8_t {
+    Playfield,
+    Hud,
+    Title,
+    Config,
+    Overlay,
+    Other,
+    Count
+};
+constexpr std::size_t kRenderSubsystemCount = static_cast<std::size_t>(RenderSubsystem::Count);
+
+const char* renderSubsystemName(RenderSubsystem s);
+
+struct RenderCounters {
+    std::uint32_t drawCalls    = 0; // GL draws (a shape with an outline is two)
+    std::uint32_t vertices     = 0;
+    std::uint32_t textureBinds = 0; // texture changes between consecutive draws
+    std::uint32_t textRebuilds = 0; // setString calls that changed the text
+
+    RenderCounters& operator+=(const RenderCounters& o) {
+        drawCalls += o.drawCalls; vertices += o.vertices;
+        textureBinds += o.textureBinds; textRebuilds += o.textRebuilds;
+        return *this;
+    }
+};
+
+// What one frame submitted, per subsystem.
+struct RenderStats {
+    std::array<RenderCounters, kRenderSubsystemCount> bySubsystem{};
+
+    const RenderCounters& operator[](RenderSubsystem s) const { return bySubsystem[static_cast<std::size_t>(s)]; }
+    RenderCounters total() const {
+        RenderCounters t;
+        for (const auto& c : bySubsystem) t += c;
+        return t;
+    }
+};
+
+// Thin wrapper around an sf::RenderTarget (window or offscreen texture) that
+// the renderers draw through, so every draw call can be counted.
+class InstrumentedTarget {
+public:
+    explicit InstrumentedTarget(sf::RenderTarget& target) : m_target(target) {}
+
+    // Attributes everything drawn while alive to one subsystem.
+    class Scope {
+    public:
+        Scope(InstrumentedTarget& t, RenderSubsystem s) : m_t(t), m_prev(t.m_current) { t.m_current = s; }
+        ~Scope() { m_t.m_current = m_prev; }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    private:
+        InstrumentedTarget& m_t;
+        RenderSubsystem     m_prev;
+    };
+
+    // Start a new frame: the running counters become lastFrame().
+    void beginFrame() {
+#ifdef TETRIS_RENDER_STATS
+        m_last = m_frame;
+        m_frame = {};
+#endif
+    }
+
+    void draw(const sf::Drawable& drawable,
+              const sf::RenderStates& states = sf::RenderStates::Default) {
+        count(1, 0, states.texture);
+        m_target.draw(drawable, states);
+    }
+
+    void draw(const sf::Shape& shape,
+              const sf::RenderStates& states = sf::RenderStates::Default) {
+#ifdef TETRIS_RENDER_STATS
+        // fill is a fan of n+2 vertices, the outline a strip of 2(n+1)
+        const auto n = static_cast<std::uint32_t>(shape.getPointCount());
+        count(1, n + 2, shape.getTexture());
+        if (shape.getOutlineThickness() != 0.f)
+            count(1, 2 * (n + 1), nullptr);
+#endif
+        m_target.draw(shape, states);
+    }
+
+    void draw(const sf::Sprite& sprite,
+              const sf::RenderStates& states = sf::RenderStates::Default) {
+        count(1, 4, &sprite.getTexture());
+        m_target.draw(sprite, states);
+    }
+
+    void draw(const sf::Text& text,
+              const sf::RenderStates& states = sf::RenderStates::Default) {
+#ifdef TETRIS_RENDER_STATS
+        // two triangles per visible glyph, drawn from the font's page texture
+        std::uint32_t glyphs = 0;
+        for (auto c : text.getString())
+            if (c != U' ' && c != U'\n' && c != U'\t') ++glyphs;
+        count(1, glyphs * 6, &text.getFont().getTexture(text.getCharacterSize()));
+#endif
+        m_target.draw(text, states);
+    }
+
+    void draw(const sf::VertexArray& va,
+              const sf::RenderStates& states = sf::RenderStates::Default) {
+        count(1, static_cast<std::uint32_t>(va.getVertexCount()), states.texture);
+        m_target.draw(va, states);
+    }
+
+    void draw(const sf::Vertex* vertices, std::size_t n, sf::PrimitiveType type,
+              const sf::RenderStates& states = sf::RenderStates::Default) {
+        count(1, static_cast<std::uint32_t>(n), states.texture);
+        m_target.draw(vertices, n, type, states);
+    }
+
+    // sf::Text re-lays out its glyphs whenever the string changes; route
+    // string updates through here so those rebuilds are visible.
+    void setString(sf::Text& text, const sf::String& str) {
+        if (text.getString() == str)
+            return;
+#ifdef TETRIS_RENDER_STATS
+        ++current().textRebuilds;
+#endif
+        text.setString(str);
+    }
+
+    sf::Vector2u getSize() const { return m_target.getSize(); }
+    void setView(const sf::View& view) { m_target.setView(view); }
+    const sf::View& getDefaultView() const { return m_target.getDefaultView(); }
+
+    sf::RenderTarget& target() { return m_target; }
+
+    // Counters of the frame in progress / of the previous complete frame.
+    // Always zero when TETRIS_RENDER_STATS is off.
+    const RenderStats& stats()     const { return m_frame; }
+    const RenderStats& lastFrame() const { return m_last; }
+
+    static constexpr bool enabled() {
+#ifdef TETRIS_RENDER_STATS
+        return true;
+#else
+        return false;
+#endif
+    }
+
+private:
+    RenderCounters& current() { return m_frame.bySubsystem[static_cast<std::size_t>(m_current)]; }
+
+    void count([[maybe_unused]] std::uint32_t draws,
+               [[maybe_unused]] std::uint32_t verts,
+               [[maybe_unused]] const void* texture) {
+#ifdef TETRIS_RENDER_STATS
+        auto& c = current();
+        c.drawCalls += draws;
+        c.vertices  += verts;
+        if (texture != m_boundTexture) {
+            ++c.textureBinds;
+            m_boundTexture = texture;
+        }
+#endif
+    }
+
+    sf::RenderTarget& m_target;
+    RenderSubsystem   m_current = RenderSubsystem::Other;
+
+    // Layout does not depend on TETRIS_RENDER_STATS, only the counting code.
+    RenderStats m_frame;
+    RenderStats m_last;
+    const void* m_boundTexture = nullptr;
+};
+
+} // namespace Tetris
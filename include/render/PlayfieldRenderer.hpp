@@ -0,0 +1,26 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include "game/Snapshot.hpp"
+#include "render/InstrumentedTarget.hpp"
+
+namespace Tetris {
+
+    class PlayfieldRenderer {
+    public:
+        explicit PlayfieldRenderer(InstrumentedTarget& target);
+
+        void setOriginPx(sf::Vector2f origin) { m_origin = origin; }
+        void draw(const RenderSnapshot& gs);
+
+    private:
+        void drawGrid();
+        void drawRace(const RaceSnapshot& race); // PB board, under the live one
+        void drawCells(const RenderSnapshot& gs);
+		void drawGhost(const RenderSnapshot& gs);
+        void drawActive(const RenderSnapshot& gs);
+
+        InstrumentedTarget& m_target;
+        sf::Vector2f m_origin{64.f, 64.f}; // left/top of playfield in pixels
+    };
+
+} // namespace Tetris
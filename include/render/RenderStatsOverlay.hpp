@@ -0,0 +1,50 @@
+// RenderStatsOverlay.hpp
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <SFML/Graphics/Font.hpp>
+#include <SFML/Graphics/RectangleShape.hpp>
+#include <SFML/Graphics/Text.hpp>
+
+#include "render/InstrumentedTarget.hpp"
+
+namespace Tetris {
+
+// Debug overlay listing last frame's render counters per subsystem, plus a
+// ring of recent frames that can be dumped to CSV. Only meaningful when
+// TETRIS_RENDER_STATS is on (see InstrumentedTarget.hpp).
+class RenderStatsOverlay {
+public:
+    static constexpr std::size_t kHistory = 600; // frames kept for CSV
+
+    explicit RenderStatsOverlay(InstrumentedTarget& target) : m_target(target) {}
+
+    void setFont(const sf::Font& font);
+
+    void toggle() { m_visible = !m_visible; }
+    bool visible() const { return m_visible; }
+
+    // Call once per frame, after InstrumentedTarget::beginFrame().
+    void record(const RenderStats& frame);
+    void draw();
+
+    // The recorded frames as CSV, oldest first.
+    std::string csv() const;
+
+private:
+    InstrumentedTarget& m_target;
+
+    std::unique_ptr<sf::Text> m_text;
+    sf::RectangleShape        m_panel;
+    bool                      m_visible = false;
+
+    std::array<RenderStats, kHistory> m_history{};
+    std::uint64_t                     m_recorded = 0; // total frames seen
+};
+
+} // namespace Tetris
@@ -1,38 +1,31 @@
 #include "core/Application.hpp"
 #include "render/Colors.hpp"
 #include "render/PlayfieldRenderer.hpp"
-#include "game/Logic.hpp"
-#include "game/Rotate.hpp"
-#include "game/Kicks.hpp"
 #include "render/Hud.hpp"
+#include "core/ThreadPool.hpp"
+#include "core/Trace.hpp"
 
+#include <SFML/Window/Clipboard.hpp>
 #include <SFML/Window/Event.hpp>
+#include <algorithm>
 #include <chrono>
-#include <filesystem>
 #include <cstdio>
+#include <ctime>
+#include <filesystem>
 #include <memory>
 #include <fstream>
+#include <sstream>
+#include <random>
 #include <string>
 #include <cstdlib>
+#include <future>
+#include <numeric>
+#include <optional>
+#include <vector>
 
 
-namespace fs = std::filesystem;
-
 namespace Tetris {
 
-static fs::path findUiFont() {
-    try {
-        if (fs::exists("resources/fonts/DejaVuSans.ttf"))
-            return "resources/fonts/DejaVuSans.ttf";
-        if (fs::exists("./resources/fonts/DejaVuSans.ttf"))
-            return "./resources/fonts/DejaVuSans.ttf";
-        if (fs::exists("../resources/fonts/DejaVuSans.ttf"))
-            return "../resources/fonts/DejaVuSans.ttf";
-    } catch (...) {
-    }
-    return {};
-}
-
 // --- Slider helpers -------------------------------------------------------
 
 static float clamp01(float v) {
@@ -47,6 +40,21 @@ static std::string formatMs(float seconds) {
     return std::to_string(ms) + " ms";
 }
 
+// ARR: 0 slides straight to the wall
+static std::string formatArr(float seconds) {
+    return seconds <= 0.f ? std::string("instant") : formatMs(seconds);
+}
+
+// SDF: multiple of gravity, "instant" at the top of the range
+static std::string formatSdf(float factor) {
+    if (factor >= kSdfInstant) return "instant";
+    return std::to_string(static_cast<int>(factor + 0.5f)) + "x";
+}
+
+static std::string formatSliderValue(const Slider& slider, float value) {
+    return slider.format ? slider.format(value) : formatMs(value);
+}
+
 void Application::initSlider(
     Slider& slider,
     const char* label,
@@ -54,12 +62,14 @@ void Application::initSlider(
     float maxValue,
     float* boundValue,
     float centerX,
-    float y
+    float y,
+    std::string (*format)(float)
 ) {
     slider.minValue   = minValue;
     slider.maxValue   = maxValue;
     slider.boundValue = boundValue;
     slider.dragging   = false;
+    slider.format     = format;
 
     // Track
     const float trackW = 420.f;
@@ -80,7 +90,7 @@ void Application::initSlider(
     slider.knob.setOutlineColor(sf::Color(40, 40, 40));
 
     // Label (left)
-    slider.label = std::make_unique<sf::Text>(m_cfgFont, label, 22);
+    slider.label = std::make_unique<sf::Text>(*m_uiFont, label, 22);
     slider.label->setFillColor(sf::Color(220, 220, 220));
     {
         auto b = slider.label->getLocalBounds();
@@ -91,8 +101,8 @@ void Application::initSlider(
 
     // Value text (right)
     slider.valueText = std::make_unique<sf::Text>(
-        m_cfgFont,
-        boundValue ? formatMs(*boundValue) : std::string(""),
+        *m_uiFont,
+        boundValue ? formatSliderValue(slider, *boundValue) : std::string(""),
         20
     );
     slider.valueText->setFillColor(sf::Color(200, 200, 200));
@@ -124,16 +134,20 @@ void Application::updateSliderVisual(Slider& slider) {
     slider.knob.setPosition(sf::Vector2f{knobX, y});
 
     if (slider.valueText) {
-        slider.valueText->setString(formatMs(value));
+        m_target.setString(*slider.valueText, formatSliderValue(slider, value));
     }
 }
 
 static const char* kConfigPath = "resources/config.json";
+static const char* kReplayDir  = "resources/replays";
+static const char* kScoreDir   = "resources/scores";
 
 void Application::loadConfig() {
     // defaults first (in case file missing / broken)
     m_moveSettings.das = 0.16f;
     m_moveSettings.arr = 0.033f;
+    m_moveSettings.sdf = 6.f;
+    m_pacing = PacingSettings{};
 
     std::ifstream in(kConfigPath, std::ios::in | std::ios::binary);
     if (!in)
@@ -160,117 +174,253 @@ void Application::loadConfig() {
         }
     };
 
+    auto parseStringField = [&](const char* key) -> std::string {
+        std::string pattern = std::string("\"") + key + "\"";
+        std::size_t pos = data.find(pattern);
+        if (pos == std::string::npos) return {};
+
+        pos = data.find(':', pos);
+        if (pos == std::string::npos) return {};
+        const std::size_t open = data.find('"', pos);
+        if (open == std::string::npos) return {};
+        const std::size_t close = data.find('"', open + 1);
+        if (close == std::string::npos) return {};
+        return data.substr(open + 1, close - open - 1);
+    };
+
     parseFloatField("das", m_moveSettings.das);
     parseFloatField("arr", m_moveSettings.arr);
-}
+    parseFloatField("sdf", m_moveSettings.sdf);
+    parseFloatField("fpsCap", m_pacing.fpsCap);
+
+    if (const std::size_t key = data.find("\"ghostRace\""); key != std::string::npos) {
+        const std::size_t value = data.find_first_not_of(" \t\r\n:", key + 11);
+        m_ghostRace = value == std::string::npos || data.compare(value, 5, "false") != 0;
+    }
 
-void Application::saveConfig() const {
-    std::ofstream out(kConfigPath, std::ios::out | std::ios::trunc);
-    if (!out)
-        return; // silently fail, game still runs
+    if (const auto mode = parseStringField("pacing"); !mode.empty()) {
+        if (!parsePacingMode(mode.c_str(), m_pacing.mode))
+            std::fprintf(stderr, "[Config] unknown pacing mode '%s' (cap, uncapped, vsync)\n", mode.c_str());
+    }
+}
 
+// Serialised here, written (atomically) on the I/O thread.
+void Application::saveConfig() {
+    std::ostringstream out;
     out << "{\n";
     out << "  \"das\": " << m_moveSettings.das << ",\n";
-    out << "  \"arr\": " << m_moveSettings.arr << "\n";
+    out << "  \"arr\": " << m_moveSettings.arr << ",\n";
+    out << "  \"sdf\": " << m_moveSettings.sdf << ",\n";
+    out << "  \"pacing\": \"" << pacingModeName(m_pacing.mode) << "\",\n";
+    out << "  \"fpsCap\": " << m_pacing.fpsCap << ",\n";
+    out << "  \"ghostRace\": " << (m_ghostRace ? "true" : "false") << "\n";
     out << "}\n";
+    m_io.writeFile(kConfigPath, out.str());
 }
 
-// simple move helper
-static bool tryMove(GameState& s, int dx, int dy) {
-    auto p = s.active;
-    p.x += dx;
-    p.y += dy;
-    if (!blocked(s, p)) {
-        s.active = p;
-        return true;
+// Gameplay keys; everything else is handled on the window thread.
+static std::optional<InputAction> gameplayAction(sf::Keyboard::Scancode key) {
+    using K = sf::Keyboard::Scancode;
+    switch (key) {
+        case K::Left:  return InputAction::Left;
+        case K::Right: return InputAction::Right;
+        case K::Down:  return InputAction::SoftDrop;
+        case K::Space: return InputAction::HardDrop;
+        // rotations with SRS-X 180s
+        case K::Up:
+        case K::X:     return InputAction::RotateCW;
+        case K::Z:     return InputAction::RotateCCW;
+        case K::A:     return InputAction::Rotate180;
+        case K::C:     return InputAction::Hold;
+        default:       return std::nullopt;
     }
-    return false;
 }
 
-// spawn next piece; if it collides immediately, flag game over
-static void spawnOrGameOver(GameState& s) {
-    spawn(s);  // from Logic.hpp
+Application::Application(const LaunchOptions& options)
+    : m_playfield(m_target)
+    , m_hud(m_target)
+{
+    if (!options.telemetryName.empty())
+        m_telemetry.open(options.telemetryName);
+    m_latency.setEnabled(options.latency);
 
-    if (blocked(s, s.active)) {
-        s.gameOver = true;
+    {
+        StartupReport::Phase phase(m_startup, "load config");
+        loadConfig(); // <-- load DAS/ARR before using them
     }
-}
+    // score stores open (and import old logs) while the window comes up
+    m_io.post([this] {
+        for (RunType run : {RunType::Sprint, RunType::Endless, RunType::Blitz})
+            m_scores[static_cast<std::size_t>(run)].open(kScoreDir, run);
+        updateSprintBest();
+    });
 
-Application::Application()
-    : m_state{}
-    , m_playfield(m_window)
-    , m_hud(m_window)
-{
-	loadConfig(); // <-- load DAS/ARR before using them
+    // Decode the title PNGs and open the UI font on worker threads while
+    // the main thread creates the window; only the GL upload stays here.
+    // Bytes come from the mapped resources.pak through the shared cache.
+    std::array<std::shared_ptr<const sf::Image>, kTitleImageCount> titleImages;
+    {
+        ThreadPool loader(std::min(ThreadPool::defaultThreadCount(), 4u));
+
+        static const char* const kTitleFiles[kTitleImageCount] = {
+            "BG.png", "HOME_BAR.png", "SPRINT.png", "ENDLESS.png", "BLITZ.png", "CONFIG.png"
+        };
+
+        std::vector<std::future<void>> decodes;
+        for (std::size_t i = 0; i < kTitleImageCount; ++i) {
+            decodes.push_back(loader.submit([this, &titleImages, i] {
+                const auto start = StartupReport::clock::now();
+                titleImages[i] = m_resources.image(std::string("assets/title_screen/") + kTitleFiles[i]);
+                m_startup.add(std::string("decode ") + kTitleFiles[i], start);
+            }));
+        }
+
+        auto fontLoaded = loader.submit([this] {
+            StartupReport::Phase phase(m_startup, "open ui font");
+            return m_resources.font("fonts/DejaVuSans.ttf");
+        });
 
-    // SFML 3: create window via create()
-    m_window.create(sf::VideoMode({1920u, 1080u}),
-                "Tetris SRS+",
-                sf::State::Fullscreen);
-    m_window.setFramerateLimit(240);
+        {
+            StartupReport::Phase phase(m_startup, "create window");
+            TETRIS_TRACE_SCOPE_CAT("create window", "assets");
+
+            // SFML 3: create window via create()
+            m_window.create(sf::VideoMode({1920u, 1080u}),
+                        "Tetris SRS+",
+                        sf::State::Fullscreen);
+            m_pacer.configure(m_window, m_pacing);
+        }
+
+        StartupReport::Phase phase(m_startup, "wait for loaders");
+        for (auto& d : decodes) d.get();
+        m_uiFont = fontLoaded.get();
+    }
 
     m_mode         = AppMode::Title;
     m_selectedMenu = MenuItem::Sprint;
 
-    initTitleSprites();   // title textures + sprites + layout
-
-	initConfigUi();
+    {
+        StartupReport::Phase phase(m_startup, "title atlas upload");
+        TETRIS_TRACE_SCOPE_CAT("title atlas upload", "assets");
+        initTitleSprites(titleImages);   // atlas texture + sprites + layout
+    }
 
-    // prepare first piece (actual start happens in startGame)
-    spawn(m_state);
+    if (m_uiFont) {
+        m_hud.setFont(*m_uiFont);
+        m_profilerOverlay.setFont(*m_uiFont);
+#ifdef TETRIS_RENDER_STATS
+        m_statsOverlay.setFont(*m_uiFont);
+#endif
+    }
+    else
+        std::fprintf(stderr, "[UI] Failed to load font; text overlays disabled\n");
+
+    // config screen UI is built on first visit (ensureConfigUi);
+    // the first piece spawns in startGame()
+
+    // --practice: a fumen, or a file whose first line is one
+    if (!options.practice.empty()) {
+        std::string fumen = options.practice;
+        if (fumen.find("115@") == std::string::npos) {
+            std::ifstream in(std::filesystem::path(options.practice));
+            if (!std::getline(in, fumen))
+                std::fprintf(stderr, "[Practice] could not read '%s'\n", options.practice.c_str());
+        }
+        if (loadPractice(fumen))
+            startPractice();
+    }
 }
 
 void Application::run() {
     using clock = std::chrono::steady_clock;
     auto last = clock::now();
+    bool firstFrame = true;
 
     while (m_window.isOpen()) {
-        auto now = clock::now();
-        float dt = std::chrono::duration<float>(now - last).count();
-        last = now;
+        const auto frameStart = clock::now();
+        const auto frameTime  = frameStart - last;
+        float dt = std::chrono::duration<float>(frameTime).count();
+        last = frameStart;
 
         processEvents();
+        const auto tEvents = clock::now();
         update(dt);
+        const auto tUpdate = clock::now();
         render();
+        const auto tRender = clock::now();
+        {
+            TETRIS_TRACE_SCOPE("display");
+            m_window.display();
+        }
+        const auto tDisplay = clock::now();
+
+        if (m_latency.enabled() && m_mode == AppMode::Playing)
+            m_latency.onDisplayed(m_renderedInputSeq, tDisplay);
+
+        m_profiler.record({
+            tEvents  - frameStart,
+            tUpdate  - tEvents,
+            tRender  - tUpdate,
+            tDisplay - tRender,
+            frameTime
+        });
+
+        const std::uint32_t simTicks = m_sim.takeTickCount();
+        if (m_telemetry.isOpen()) {
+            const RenderSnapshot& snap = m_sim.latest();
+            TelemetrySample sample;
+            sample.frameIndex   = m_frameIndex;
+            sample.timestampNs  = static_cast<std::uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(tDisplay.time_since_epoch()).count());
+            sample.frameMs      = std::chrono::duration<double, std::milli>(frameTime).count();
+            sample.simTicks     = simTicks;
+            sample.inputEvents  = m_frameInputEvents;
+            sample.piecesPlaced = static_cast<std::uint64_t>(snap.piecesPlaced);
+            sample.linesCleared = static_cast<std::uint64_t>(snap.totalLinesCleared);
+            sample.mode         = static_cast<std::uint64_t>(m_mode);
+            m_telemetry.publish(sample);
+        }
+        ++m_frameIndex;
+        m_frameInputEvents = 0;
+
+        if (firstFrame) {
+            firstFrame = false;
+            m_startup.print(tDisplay);
+        }
+
+        m_pacer.wait();
     }
 }
 
 void Application::setupRunForMenuSelection() {
     switch (m_selectedMenu) {
         case MenuItem::Sprint:
-            m_state.runType = RunType::Sprint;
+            m_runType = RunType::Sprint;
             break;
         case MenuItem::Endless:
-            m_state.runType = RunType::Endless;
+            m_runType = RunType::Endless;
             break;
         case MenuItem::Blitz:
-            m_state.runType = RunType::Blitz;
+            m_runType = RunType::Blitz;
             break;
         default:
-            m_state.runType = RunType::Endless;
+            m_runType = RunType::Endless;
             break;
     }
-
-    m_state.totalLinesCleared = 0;
-    m_state.gameOver          = false;
-
-    if (m_state.runType == RunType::Sprint) {
-        m_state.sprintTargetLines   = 40;
-        m_state.sprintCompleted     = false;
-        m_state.sprintTime          = 0.f;
-        m_state.sprintTimerRunning  = false;
-    } else {
-        m_state.sprintCompleted     = false;
-        m_state.sprintTime          = 0.f;
-        m_state.sprintTimerRunning  = false;
-    }
 }
 
 
 void Application::processEvents() {
+    TETRIS_TRACE_SCOPE("processEvents");
     while (const auto ev = m_window.pollEvent()) {
+        // stamp on arrival: the simulation applies gameplay input at this time
+        const auto arrived = SimulationThread::clock::now();
+        ++m_frameInputEvents;
+
         if (ev->is<sf::Event::Closed>()) {
 			saveConfig();
+            if (m_latency.enabled())
+                writeLatencyCsv();
             m_window.close();
             continue;
         }
@@ -279,6 +429,42 @@ void Application::processEvents() {
         if (const auto* kp = ev->getIf<sf::Event::KeyPressed>()) {
             using K = sf::Keyboard::Scancode;
 
+            // F9: write the trace recorded so far (needs --trace)
+            if (kp->scancode == K::F9) {
+                m_io.post([] { Trace::flush(); });
+                continue;
+            }
+
+            // F7: write latency samples so far (needs --latency)
+            if (kp->scancode == K::F7) {
+                if (m_latency.enabled())
+                    writeLatencyCsv();
+                continue;
+            }
+
+            // F3: frame profiler overlay, F4: reset its histograms
+            if (kp->scancode == K::F3) {
+                m_profilerOverlay.toggle();
+                continue;
+            }
+            if (kp->scancode == K::F4) {
+                m_profiler.reset();
+                continue;
+            }
+
+#ifdef TETRIS_RENDER_STATS
+            // debug keys, any screen: F1 render stats overlay, F2 dump to CSV
+            if (kp->scancode == K::F1) {
+                m_statsOverlay.toggle();
+                continue;
+            }
+            if (kp->scancode == K::F2) {
+                m_io.writeFile("render_stats.csv", m_statsOverlay.csv());
+                std::fprintf(stderr, "[RenderStats] saving render_stats.csv\n");
+                continue;
+            }
+#endif
+
             // -------- TITLE SCREEN INPUT --------
             if (m_mode == AppMode::Title) {
                 switch (kp->scancode) {
@@ -306,16 +492,26 @@ void Application::processEvents() {
 					case K::Space:
     					if (m_selectedMenu == MenuItem::Config) {
     					    // go to config screen instead of starting the game
+    					    ensureConfigUi();
     					    m_mode = AppMode::Config;
     					} else {
 							setupRunForMenuSelection();
     					    startGame();
     					}
-    					return;
+    					continue;
 
                     case K::Escape:
                         m_window.close();
-                        return;
+                        continue;
+
+                    case K::V: {
+                        // Ctrl+V: practice the fumen on the clipboard
+                        if (!kp->control)
+                            break;
+                        const auto utf8 = sf::Clipboard::getString().toUtf8();
+                        if (loadPractice(std::string(utf8.begin(), utf8.end())))
+                            startPractice();
+                    } continue;
 
                     default:
                         break;
@@ -332,14 +528,14 @@ void Application::processEvents() {
 			            // back to title
 						saveConfig();
 			            m_mode = AppMode::Title;
-			            return;
+			            continue;
 
 			        case K::Enter:
 			        case K::Space:
 			            // also go back for now
 						saveConfig();
 			            m_mode = AppMode::Title;
-			            return;
+			            continue;
 
 			        default:
 			            break;
@@ -349,124 +545,44 @@ void Application::processEvents() {
 			    continue;
 			}
 
-			if (m_mode == AppMode::Playing && m_state.gameOver) {
+            // -------- SHARING / PRACTICE (also after a game over) --------
+            if (kp->control && kp->scancode == K::C) {
+                copyBoardAsFumen();
+                continue;
+            }
+            if (m_practice && (kp->scancode == K::R || kp->scancode == K::Tab)) {
+                if (kp->scancode == K::Tab)
+                    m_practicePage = (m_practicePage + 1) % m_practicePages.size();
+                startPractice();
+                continue;
+            }
+
+			if (m_mode == AppMode::Playing && m_sim.latest().gameOver) {
  				// maybe allow Esc to quit, Enter to restart later
     			if (kp->scancode == K::Escape)
     			    m_window.close();
-    			return;
+    			continue;
 			}
 
             // -------- GAMEPLAY INPUT --------
-            switch (kp->scancode) {
-                case K::Left: {
-                    // one immediate step
-                    if (tryMove(m_state, -1, 0)
-                        && m_state.grounded
-                        && m_state.lockResets < m_state.maxLockResets) {
-                        m_state.lockTimer = 0.f;
-                        ++m_state.lockResets;
-                    }
-
-                    // start DAS for left, cancel right
-                    m_leftState.held      = true;
-                    m_leftState.heldTime  = 0.f;
-                    m_rightState.held     = false;
-                    m_rightState.heldTime = 0.f;
-                } break;
-
-                case K::Right: {
-                    // one immediate step
-                    if (tryMove(m_state,  1, 0)
-                        && m_state.grounded
-                        && m_state.lockResets < m_state.maxLockResets) {
-                        m_state.lockTimer = 0.f;
-                        ++m_state.lockResets;
-                    }
-
-                    // start DAS for right, cancel left
-                    m_rightState.held      = true;
-                    m_rightState.heldTime  = 0.f;
-                    m_leftState.held       = false;
-                    m_leftState.heldTime   = 0.f;
-                } break;
-
-                case K::Down: {
-                    tryMove(m_state, 0, -1); // soft drop
-                } break;
-
-                case K::Space: {
-                    m_state.active = dropToGround(m_state);
-                    lockPiece(m_state);
-                    clearLines(m_state);
-
-                    spawnOrGameOver(m_state);
-                    if (m_state.gameOver) {
-                        return; // stop processing this event if topped out
-                    }
-
-                    m_state.canHold = true;
-                } break;
-
-				// rotations with SRS-X 180s
-                case K::Up:
-                case K::X: {
-                    if (tryRotateWithKicks(m_state, +1, Kick180Mode::SRSX_180)
-                        && m_state.grounded
-                        && m_state.lockResets < m_state.maxLockResets) {
-                        m_state.lockTimer = 0.f;
-                        ++m_state.lockResets;
-                    }
-                } break;
-
-                case K::Z: {
-                    if (tryRotateWithKicks(m_state, -1, Kick180Mode::SRSX_180)
-                        && m_state.grounded
-                        && m_state.lockResets < m_state.maxLockResets) {
-                        m_state.lockTimer = 0.f;
-                        ++m_state.lockResets;
-                    }
-                } break;
-
-                case K::A: { // 180°
-                    if (tryRotateWithKicks(m_state, +2, Kick180Mode::SRSX_180)
-                        && m_state.grounded
-                        && m_state.lockResets < m_state.maxLockResets) {
-                        m_state.lockTimer = 0.f;
-                        ++m_state.lockResets;
-                    }
-                } break;
-
-                // HOLD key (missing case you mentioned)
-                case K::C: {
-    				holdPiece(m_state);
-				} break;
-
-
-                case K::Escape:
-			    	// back to title
-					saveConfig();
-			        m_mode = AppMode::Title;
-			        return;
-
-                default:
-                    break;
+            if (kp->scancode == K::Escape) {
+                // back to title
+                m_sim.stop();
+                saveConfig();
+                m_mode = AppMode::Title;
+                continue;
+            }
+            if (const auto action = gameplayAction(kp->scancode)) {
+                if (const auto seq = m_sim.post(*action, true, arrived))
+                    m_latency.track(seq, *action, arrived);
             }
 		}
 
         // ---- KeyReleased: stop DAS when letting go ----
         if (const auto* kr = ev->getIf<sf::Event::KeyReleased>()) {
-            using K = sf::Keyboard::Scancode;
-            switch (kr->scancode) {
-                case K::Left:
-                    m_leftState.held     = false;
-                    m_leftState.heldTime = 0.f;
-                    break;
-                case K::Right:
-                    m_rightState.held     = false;
-                    m_rightState.heldTime = 0.f;
-                    break;
-                default:
-                    break;
+            if (m_mode == AppMode::Playing) {
+                if (const auto action = gameplayAction(kr->scancode))
+                    m_sim.post(*action, false, arrived);
             }
         }
 
@@ -500,7 +616,7 @@ void Application::processEvents() {
 }
 
 void Application::onConfigMousePressed(const sf::Vector2f& mousePos) {
-    if (!m_cfgFontOk) return;
+    if (!m_cfgUiReady) return;
 
     auto checkSlider = [&](Slider& s) {
         auto knobBounds  = s.knob.getGlobalBounds();
@@ -525,11 +641,13 @@ void Application::onConfigMousePressed(const sf::Vector2f& mousePos) {
 
     checkSlider(m_dasSlider);
     checkSlider(m_arrSlider);
+    checkSlider(m_sdfSlider);
 }
 
 void Application::onConfigMouseReleased() {
     m_dasSlider.dragging = false;
     m_arrSlider.dragging = false;
+    m_sdfSlider.dragging = false;
 }
 
 void Application::onConfigMouseMoved(const sf::Vector2f& mousePos) {
@@ -548,97 +666,100 @@ void Application::onConfigMouseMoved(const sf::Vector2f& mousePos) {
 
     updateDraggingSlider(m_dasSlider);
     updateDraggingSlider(m_arrSlider);
+    updateDraggingSlider(m_sdfSlider);
 }
 
-void Application::updateAutoShift(float dt) {
-    auto stepSide = [&](MoveKeyState& st, int dir) {
-        if (!st.held)
-            return;
-
-        st.heldTime += dt;
+// Shelf-pack the title images into one atlas image. Empty (failed) images
+// get an empty rect. A small gap keeps smoothing from bleeding across.
+static sf::Image packTitleAtlas(const std::array<std::shared_ptr<const sf::Image>, kTitleImageCount>& images,
+                                std::array<sf::IntRect, kTitleImageCount>& rects) {
+    constexpr unsigned gap = 2;
 
-        // not past DAS yet → no auto-repeat
-        if (st.heldTime < m_moveSettings.das)
-            return;
+    auto sizeOf = [&](std::size_t i) {
+        return images[i] ? images[i]->getSize() : sf::Vector2u{};
+    };
 
-        float extra = st.heldTime - m_moveSettings.das;
-        float arr   = (m_moveSettings.arr <= 0.f) ? 0.f : m_moveSettings.arr;
+    unsigned widest = 0;
+    for (std::size_t i = 0; i < kTitleImageCount; ++i) widest = std::max(widest, sizeOf(i).x);
+    const unsigned limitW = std::max(2048u, widest);
 
-        bool moved = false;
+    std::array<std::size_t, kTitleImageCount> order{};
+    std::iota(order.begin(), order.end(), std::size_t{0});
+    std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+        return sizeOf(a).y > sizeOf(b).y;
+    });
 
-        if (arr == 0.f) {
-            // ARR = 0 → move every frame after DAS
-            moved = tryMove(m_state, dir, 0);
-        } else {
-            while (extra >= 0.f) {
-                if (tryMove(m_state, dir, 0))
-                    moved = true;
-                extra -= arr;
-            }
+    unsigned x = 0, y = 0, shelfH = 0, atlasW = 0;
+    for (std::size_t idx : order) {
+        const auto sz = sizeOf(idx);
+        if (sz.x == 0 || sz.y == 0) {
+            rects[idx] = {};
+            continue;
         }
-
-        if (moved
-            && m_state.grounded
-            && m_state.lockResets < m_state.maxLockResets) {
-            m_state.lockTimer = 0.f;
-            ++m_state.lockResets;
+        if (x > 0 && x + sz.x > limitW) {
+            y += shelfH + gap;
+            x = 0;
+            shelfH = 0;
         }
-
-        // keep timer bounded
-        if (arr > 0.f)
-            st.heldTime = m_moveSettings.das + std::max(extra, 0.f);
-    };
-
-    // left and right
-    stepSide(m_leftState,  -1);
-    stepSide(m_rightState, +1);
-}
-
-static void loadTextureOrWarn(sf::Texture& tex, const fs::path& p) {
-    if (!tex.loadFromFile(p.string())) {
-        std::fprintf(stderr, "[Title] Failed to load texture: %s\n",
-                     p.string().c_str());
-    } else {
-        std::fprintf(stderr, "[Title] Loaded texture: %s\n",
-                     p.string().c_str());
+        rects[idx] = sf::IntRect({static_cast<int>(x), static_cast<int>(y)},
+                                 {static_cast<int>(sz.x), static_cast<int>(sz.y)});
+        x += sz.x + gap;
+        shelfH = std::max(shelfH, sz.y);
+        atlasW = std::max(atlasW, x);
     }
-    tex.setSmooth(true);
-}
-
-void Application::initTitleSprites() {
-    fs::path base = "resources/assets/title_screen";
-
-    if (!fs::exists(base / "HOME_BAR.png")) {
-        fs::path alt = "../resources/assets/title_screen";
-        if (fs::exists(alt / "HOME_BAR.png")) {
-            base = alt;
+    const unsigned atlasH = y + shelfH;
+
+    if (atlasW == 0 || atlasH == 0)
+        return {};
+
+    sf::Image atlas({atlasW, atlasH}, sf::Color::Transparent);
+    for (std::size_t i = 0; i < kTitleImageCount; ++i) {
+        if (rects[i].size.x == 0) continue;
+        const sf::Vector2u dest{static_cast<unsigned>(rects[i].position.x),
+                                static_cast<unsigned>(rects[i].position.y)};
+        if (!atlas.copy(*images[i], dest)) {
+            std::fprintf(stderr, "[Title] Failed to pack image %zu into atlas\n", i);
+            rects[i] = {};
         }
     }
+    return atlas;
+}
 
-    std::fprintf(stderr, "[Title] assets base: %s\n", base.string().c_str());
+sf::Vector2u Application::titleImageSize(TitleImage img) const {
+    const auto& r = m_titleRects[static_cast<std::size_t>(img)];
+    return {static_cast<unsigned>(r.size.x), static_cast<unsigned>(r.size.y)};
+}
 
-    // --- load textures ---
-    loadTextureOrWarn(m_titleBgTex,  base / "BG.png");
-    loadTextureOrWarn(m_homeBarTex,  base / "HOME_BAR.png");
-    loadTextureOrWarn(m_sprintTex,   base / "SPRINT.png");
-    loadTextureOrWarn(m_endlessTex,  base / "ENDLESS.png");
-    loadTextureOrWarn(m_blitzTex,    base / "BLITZ.png");
-    loadTextureOrWarn(m_configTex,   base / "CONFIG.png");
+void Application::initTitleSprites(const std::array<std::shared_ptr<const sf::Image>, kTitleImageCount>& images) {
+    // --- pack + upload one atlas texture ---
+    const sf::Image atlas = packTitleAtlas(images, m_titleRects);
+    const auto atlasSize = atlas.getSize();
+    if (atlasSize.x > sf::Texture::getMaximumSize() || atlasSize.y > sf::Texture::getMaximumSize()) {
+        std::fprintf(stderr, "[Title] Atlas %ux%u exceeds max texture size %u\n",
+                     atlasSize.x, atlasSize.y, sf::Texture::getMaximumSize());
+    }
+    if (atlasSize.x > 0 && !m_titleAtlas.loadFromImage(atlas)) {
+        std::fprintf(stderr, "[Title] Failed to upload atlas texture\n");
+    }
+    m_titleAtlas.setSmooth(true);
 
     // --- create sprites (SFML 3: must pass a texture) ---
-    m_titleBgSprite  = std::make_unique<sf::Sprite>(m_titleBgTex);
-    m_homeBarSprite  = std::make_unique<sf::Sprite>(m_homeBarTex);
-    m_sprintSprite   = std::make_unique<sf::Sprite>(m_sprintTex);
-    m_endlessSprite  = std::make_unique<sf::Sprite>(m_endlessTex);
-    m_blitzSprite    = std::make_unique<sf::Sprite>(m_blitzTex);
-    m_configSprite   = std::make_unique<sf::Sprite>(m_configTex);
+    auto makeSprite = [&](TitleImage img) {
+        return std::make_unique<sf::Sprite>(m_titleAtlas, m_titleRects[static_cast<std::size_t>(img)]);
+    };
+    m_titleBgSprite  = makeSprite(TitleImage::Bg);
+    m_homeBarSprite  = makeSprite(TitleImage::HomeBar);
+    m_sprintSprite   = makeSprite(TitleImage::Sprint);
+    m_endlessSprite  = makeSprite(TitleImage::Endless);
+    m_blitzSprite    = makeSprite(TitleImage::Blitz);
+    m_configSprite   = makeSprite(TitleImage::Config);
 
     const auto winSize = m_window.getSize();
     const float winW = static_cast<float>(winSize.x);
     const float winH = static_cast<float>(winSize.y);
 
     // --- background: cover window ---
-    if (auto s = m_titleBgTex.getSize(); s.x > 0 && s.y > 0) {
+    if (auto s = titleImageSize(TitleImage::Bg); s.x > 0 && s.y > 0) {
         float scaleX = winW / static_cast<float>(s.x);
         float scaleY = winH / static_cast<float>(s.y);
         float scale  = std::max(scaleX, scaleY);
@@ -647,7 +768,7 @@ void Application::initTitleSprites() {
     }
 
     // --- HOME bar at top, full width ---
-    if (auto s = m_homeBarTex.getSize(); s.x > 0 && s.y > 0) {
+    if (auto s = titleImageSize(TitleImage::HomeBar); s.x > 0 && s.y > 0) {
         float scale = winW / static_cast<float>(s.x);
         m_homeBarSprite->setScale(sf::Vector2f{scale, scale});
         m_homeBarSprite->setPosition(sf::Vector2f{0.f, 0.f});
@@ -657,7 +778,7 @@ void Application::initTitleSprites() {
     float menuScale = 1.f;
     float rowHeight = 0.f;
     {
-        auto ts = m_sprintTex.getSize();          // reference size
+        auto ts = titleImageSize(TitleImage::Sprint);   // reference size
         if (ts.x > 0 && ts.y > 0) {
             const float targetW = winW * 0.65f;
             menuScale = targetW / static_cast<float>(ts.x);
@@ -718,24 +839,24 @@ void Application::updateMenuHighlight() {
     });
 }
 
-void Application::initConfigUi() {
-    const auto fontPath = findUiFont();
-    if (fontPath.empty() || !m_cfgFont.openFromFile(fontPath.string())) {
-        m_cfgFontOk = false;
-        m_cfgTitle.reset();
-        m_cfgBody.reset();
-        m_cfgHint.reset();
+void Application::ensureConfigUi() {
+    if (m_cfgUiReady || !m_uiFont)
         return;
-    }
 
-    m_cfgFontOk = true;
+    const auto start = StartupReport::clock::now();
+    initConfigUi();
+    m_cfgUiReady = true;
+    std::fprintf(stderr, "[Startup] config ui built lazily in %.2f ms\n",
+                 std::chrono::duration<double, std::milli>(StartupReport::clock::now() - start).count());
+}
 
+void Application::initConfigUi() {
     const auto winSize = m_window.getSize();
     const float winW = static_cast<float>(winSize.x);
     const float winH = static_cast<float>(winSize.y);
 
     // Title
-    m_cfgTitle = std::make_unique<sf::Text>(m_cfgFont, "CONFIG", 40);
+    m_cfgTitle = std::make_unique<sf::Text>(*m_uiFont, "CONFIG", 40);
     m_cfgTitle->setFillColor(sf::Color(230, 230, 230));
     {
         auto b = m_cfgTitle->getLocalBounds();
@@ -746,8 +867,8 @@ void Application::initConfigUi() {
 
     // Subtitle / body
     m_cfgBody = std::make_unique<sf::Text>(
-        m_cfgFont,
-        "Movement settings (DAS / ARR)",
+        *m_uiFont,
+        "Movement settings (DAS / ARR / SDF)",
         22
     );
     m_cfgBody->setFillColor(sf::Color(200, 200, 200));
@@ -760,7 +881,7 @@ void Application::initConfigUi() {
 
     // Hint
     m_cfgHint = std::make_unique<sf::Text>(
-        m_cfgFont,
+        *m_uiFont,
         "Esc: Back to title",
         18
     );
@@ -775,106 +896,170 @@ void Application::initConfigUi() {
     const float centerX = winW * 0.5f;
     const float dasY    = winH * 0.40f;
     const float arrY    = winH * 0.52f;
+    const float sdfY    = winH * 0.64f;
 
     // Common ranges (tweak to taste)
     // DAS: 40 ms .. 300 ms
-    // ARR: 0 ms .. 80 ms
+    // ARR: 0 ms (instant) .. 80 ms
+    // SDF: 1x .. 40x gravity, then instant
     initSlider(m_dasSlider, "DAS", 0.040f, 0.300f, &m_moveSettings.das, centerX, dasY);
-    initSlider(m_arrSlider, "ARR", 0.000f, 0.080f, &m_moveSettings.arr, centerX, arrY);
+    initSlider(m_arrSlider, "ARR", 0.000f, 0.080f, &m_moveSettings.arr, centerX, arrY, formatArr);
+    initSlider(m_sdfSlider, "SDF", 1.f, kSdfInstant, &m_moveSettings.sdf, centerX, sdfY, formatSdf);
 }
 
-void Application::startGame() {
-    const RunType run    = m_state.runType;
-    const int     target = m_state.sprintTargetLines;
-
-    m_state = GameState{};  // reset
+void Application::recordRunResult() {
+    const RenderSnapshot& snap = m_sim.latest();
+    if (m_runResolved || !snap.gameOver)
+        return;
+    m_runResolved = true;
+
+    ScoreRecord r;
+    r.run      = m_runType;
+    r.finished = m_runType != RunType::Sprint || snap.totalLinesCleared >= 40;
+    r.lines    = static_cast<std::uint32_t>(snap.totalLinesCleared);
+    r.pieces   = static_cast<std::uint32_t>(snap.piecesPlaced);
+    r.timeUs   = m_runType == RunType::Sprint ? snap.sprintTimeUs : snap.timeUs;
+    r.dateUnix = m_runStarted;
+    r.seed     = m_runSeed;
+    r.replay   = m_runReplay.filename().string();
+
+    m_io.post([this, r = std::move(r)] {
+        ScoreStore& store = m_scores[static_cast<std::size_t>(r.run)];
+        if (!store.isOpen())
+            return;
+        const std::size_t place   = store.rank(r);
+        const double      percent = store.percentile(r); // against the runs before it
+        if (!store.add(r))
+            return;
+        std::fprintf(stderr, "[Scores] %s: #%zu of %zu, at least as good as %.1f%% of earlier runs\n",
+                     runTypeName(r.run), place + 1, store.size(), percent);
+        if (r.run == RunType::Sprint && place == 0)
+            updateSprintBest();
+    });
+}
 
-    m_state.runType          = run;
-    m_state.sprintTargetLines = target;
+void Application::updateSprintBest() {
+    // top of the board, O(log n) from the index; an imported PB may have
+    // no replay, then there is nothing to race
+    const auto pb = m_scores[static_cast<std::size_t>(RunType::Sprint)].best();
+    std::lock_guard lock(m_pbMutex);
+    m_pbReplay = pb && pb->finished ? pb->replay : std::string{};
+}
 
-    m_state.totalLinesCleared = 0;
-    m_state.gameOver          = false;
-    m_state.sprintCompleted   = false;
-    m_state.sprintTime        = 0.f;
+void Application::startGame() {
+    // fresh seed per run; together with the inputs it reproduces the run
+    std::random_device rd;
+    const std::uint64_t seed = (std::uint64_t{rd()} << 32) ^ rd();
+    m_runSeed    = seed;
+    m_runStarted = static_cast<std::int64_t>(std::time(nullptr));
+
+    char name[64];
+    std::snprintf(name, sizeof(name), "%lld-%016llx-%s.tsrr",
+                  static_cast<long long>(m_runStarted),
+                  static_cast<unsigned long long>(seed), runTypeName(m_runType));
+    m_runReplay   = std::filesystem::path(kReplayDir) / name;
+    m_runResolved = false;
+    m_practice    = false;
+
+    std::filesystem::path race;
+    if (m_runType == RunType::Sprint && m_ghostRace) {
+        std::lock_guard lock(m_pbMutex);
+        if (!m_pbReplay.empty())
+            race = std::filesystem::path(kReplayDir) / m_pbReplay;
+    }
+    m_sim.start(m_runType, m_moveSettings, seed, m_runReplay, race);
+    m_latency.dropPending();
+    m_mode = AppMode::Playing;
+}
 
-    m_state.sprintTimerRunning =
-        (m_state.runType == RunType::Sprint);
+bool Application::loadPractice(std::string_view fumen) {
+    if (!decodeFumen(fumen, m_practicePages)) {
+        std::fprintf(stderr, "[Practice] not a v115 fumen\n");
+        return false;
+    }
+    m_practicePage = 0;
+    std::fprintf(stderr, "[Practice] loaded %zu page(s); R restarts, Tab next page\n", m_practicePages.size());
+    return true;
+}
 
+void Application::startPractice() {
+    std::random_device rd;
+    const std::uint64_t seed = (std::uint64_t{rd()} << 32) ^ rd();
+
+    // the board goes in as a checkpoint of a fresh Endless run; gravity and
+    // the bag carry on from there like any other run
+    Simulation board;
+    board.reset(RunType::Endless, m_moveSettings, seed);
+    Simulation::Checkpoint setup = board.checkpoint();
+    if (!fumenToState(m_practicePages[m_practicePage], setup.state))
+        std::fprintf(stderr, "[Practice] page %zu doesn't fit a 10x22 board, playing what does\n",
+                     m_practicePage + 1);
+
+    m_runType     = RunType::Endless;
+    m_runSeed     = seed;
+    m_runReplay.clear();
+    m_runResolved = true; // nothing to record
+    m_practice    = true;
+    m_sim.start(RunType::Endless, m_moveSettings, seed, {}, {}, &setup);
+    m_latency.dropPending();
     m_mode = AppMode::Playing;
-    spawn(m_state);
+}
+
+void Application::copyBoardAsFumen() {
+    // the latest snapshot has everything a page shows: board, piece, hold, queue
+    const RenderSnapshot& snap = m_sim.latest();
+    GameState s;
+    s.grid     = snap.grid;
+    s.active   = snap.active;
+    s.hasHold  = snap.hasHold;
+    s.holdType = snap.holdType;
+    s.gameOver = snap.gameOver;
+    s.bag.preload(snap.next);
+
+    FumenPage page;
+    stateToFumen(s, page);
+    std::string fumen;
+    encodeFumen({&page, 1}, fumen);
+    sf::Clipboard::setString(fumen);
+    std::fprintf(stderr, "[Practice] copied %s\n", fumen.c_str());
 }
 
 
 void Application::update(float dt) {
+    TETRIS_TRACE_SCOPE("update");
     m_hud.update(dt);
+    m_profilerOverlay.update(dt);
 
-    // only run physics in Playing mode
-    if (m_mode != AppMode::Playing)
-        return;
-
-    // once gameOver is set, freeze logic (you can later add restart)
-    if (m_state.gameOver)
-        return;
-
-    // Sprint timer
-    if (m_state.runType == RunType::Sprint && m_state.sprintTimerRunning) {
-        m_state.sprintTime += dt;
-    }
-
-    m_state.fallAcc += m_state.gravity * dt;
-    bool movedDown = false;
-
-    // gravity step(s)
-    while (m_state.fallAcc >= 1.f) {
-        m_state.fallAcc -= 1.f;
-        if (tryMove(m_state, 0, -1)) {
-            movedDown = true;
-        } else {
-            m_state.grounded = true;
-            break;
+    if (m_latency.enabled()) {
+        m_latencyRefresh += dt;
+        if (m_latencyRefresh >= 0.25f) {
+            m_latencyRefresh = 0.f;
+            m_hud.setDiagnostics(m_latency.summary());
         }
     }
 
-    if (m_state.grounded) {
-        m_state.lockTimer += dt;
-        if (canMove(m_state, m_state.active, 0, -1)) {
-            // we can move down again → unground
-            m_state.grounded    = false;
-            m_state.lockTimer   = 0.f;
-            m_state.lockResets  = 0;
-        } else if (m_state.lockTimer >= m_state.lockDelay) {
-            // lock + clear + spawn; top-out if spawn overlaps
-            lockPiece(m_state);
-            clearLines(m_state);
-
-            spawnOrGameOver(m_state);
-            if (m_state.gameOver) {
-                return;
-            }
-        }
-    } else if (movedDown) {
-        // check if we came to rest
-        m_state.grounded = canMove(m_state, m_state.active, 0, -1)
-                         ? false
-                         : m_state.grounded;
-        if (!m_state.grounded) {
-            m_state.lockTimer  = 0.f;
-            m_state.lockResets = 0;
-        }
-    }
+    // gameplay runs on the simulation thread (m_sim)
+    if (m_mode == AppMode::Playing)
+        recordRunResult();
+}
+
+// Formatted here, written on the I/O thread (which logs a failure).
+void Application::writeLatencyCsv() {
+    m_io.writeFile("latency.csv", m_latency.csv());
+    std::fprintf(stderr, "[Latency] saving latency.csv\n");
 }
 
 
 void Application::renderTitle() {
-    if (m_titleBgSprite)   m_window.draw(*m_titleBgSprite);
-    if (m_homeBarSprite)   m_window.draw(*m_homeBarSprite);
+    if (m_titleBgSprite)   m_target.draw(*m_titleBgSprite);
+    if (m_homeBarSprite)   m_target.draw(*m_homeBarSprite);
 
-    m_window.draw(m_menuHighlight);
+    m_target.draw(m_menuHighlight);
 
-    if (m_sprintSprite)    m_window.draw(*m_sprintSprite);
-    if (m_endlessSprite)   m_window.draw(*m_endlessSprite);
-    if (m_blitzSprite)     m_window.draw(*m_blitzSprite);
-    if (m_configSprite)    m_window.draw(*m_configSprite);
+    if (m_sprintSprite)    m_target.draw(*m_sprintSprite);
+    if (m_endlessSprite)   m_target.draw(*m_endlessSprite);
+    if (m_blitzSprite)     m_target.draw(*m_blitzSprite);
+    if (m_configSprite)    m_target.draw(*m_configSprite);
 }
 
 void Application::renderConfig() {
@@ -885,47 +1070,77 @@ void Application::renderConfig() {
         static_cast<float>(m_window.getSize().y)
     });
     panel.setFillColor(sf::Color(8, 10, 16));
-    m_window.draw(panel);
+    m_target.draw(panel);
 
-    if (!m_cfgFontOk)
+    if (!m_cfgUiReady)
         return;
 
-    if (m_cfgTitle) m_window.draw(*m_cfgTitle);
-    if (m_cfgBody)  m_window.draw(*m_cfgBody);
-    if (m_cfgHint)  m_window.draw(*m_cfgHint);
+    if (m_cfgTitle) m_target.draw(*m_cfgTitle);
+    if (m_cfgBody)  m_target.draw(*m_cfgBody);
+    if (m_cfgHint)  m_target.draw(*m_cfgHint);
 
     // DAS slider
-    m_window.draw(m_dasSlider.track);
-    m_window.draw(m_dasSlider.knob);
-    if (m_dasSlider.label)     m_window.draw(*m_dasSlider.label);
-    if (m_dasSlider.valueText) m_window.draw(*m_dasSlider.valueText);
+    m_target.draw(m_dasSlider.track);
+    m_target.draw(m_dasSlider.knob);
+    if (m_dasSlider.label)     m_target.draw(*m_dasSlider.label);
+    if (m_dasSlider.valueText) m_target.draw(*m_dasSlider.valueText);
 
     // ARR slider
-    m_window.draw(m_arrSlider.track);
-    m_window.draw(m_arrSlider.knob);
-    if (m_arrSlider.label)     m_window.draw(*m_arrSlider.label);
-    if (m_arrSlider.valueText) m_window.draw(*m_arrSlider.valueText);
+    m_target.draw(m_arrSlider.track);
+    m_target.draw(m_arrSlider.knob);
+    if (m_arrSlider.label)     m_target.draw(*m_arrSlider.label);
+    if (m_arrSlider.valueText) m_target.draw(*m_arrSlider.valueText);
+
+    // SDF slider
+    m_target.draw(m_sdfSlider.track);
+    m_target.draw(m_sdfSlider.knob);
+    if (m_sdfSlider.label)     m_target.draw(*m_sdfSlider.label);
+    if (m_sdfSlider.valueText) m_target.draw(*m_sdfSlider.valueText);
 }
 
 void Application::render() {
+    TETRIS_TRACE_SCOPE("render");
+    m_target.beginFrame();
+#ifdef TETRIS_RENDER_STATS
+    m_statsOverlay.record(m_target.lastFrame());
+#endif
+
     m_window.clear(Colors::Bg);
 
     if (m_mode == AppMode::Title) {
+        InstrumentedTarget::Scope scope(m_target, RenderSubsystem::Title);
         // Title uses screen-space coordinates
         m_window.setView(m_window.getDefaultView());
         renderTitle();
     } else if (m_mode == AppMode::Config) {
+        InstrumentedTarget::Scope scope(m_target, RenderSubsystem::Config);
         renderConfig();
     } else {
-        // Playfield (uses whatever view PlayfieldRenderer wants)
-        m_playfield.draw(m_state);
+        // newest state the simulation thread has published
+        const RenderSnapshot& snap = m_sim.latest();
+        m_renderedInputSeq = snap.inputSeq;
+        {
+            // Playfield (uses whatever view PlayfieldRenderer wants)
+            InstrumentedTarget::Scope scope(m_target, RenderSubsystem::Playfield);
+            m_playfield.draw(snap);
+        }
 
         // Reset to default view for HUD (screen-space)
         m_window.setView(m_window.getDefaultView());
-        m_hud.draw(m_state);
+        InstrumentedTarget::Scope scope(m_target, RenderSubsystem::Hud);
+        m_hud.draw(snap);
+    }
+
+    {
+        InstrumentedTarget::Scope scope(m_target, RenderSubsystem::Overlay);
+        m_window.setView(m_window.getDefaultView());
+#ifdef TETRIS_RENDER_STATS
+        m_statsOverlay.draw();
+#endif
+        m_profilerOverlay.draw();
     }
 
-    m_window.display();
+    // display() is timed separately in run()
 }
 
 } // namespace Tetris
@@ -0,0 +1,120 @@
+#include "core/BackgroundIo.hpp"
+#include "core/FileSync.hpp"
+#include "core/Trace.hpp"
+
+#include <cstdio>
+#include <system_error>
+#include <vector>
+
+namespace Tetris {
+
+BackgroundIo::BackgroundIo()
+    : m_thread([this] { workerLoop(); })
+{
+}
+
+BackgroundIo::~BackgroundIo() {
+    {
+        std::lock_guard lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wake.notify_one();
+    m_thread.join();
+}
+
+void BackgroundIo::writeFile(std::filesystem::path path, std::string contents) {
+    {
+        std::lock_guard lock(m_mutex);
+        // still queued: the newer contents win, the queue doesn't grow
+        for (Job& job : m_jobs) {
+            if (!job.run && job.path == path) {
+                job.contents = std::move(contents);
+                return;
+            }
+        }
+    }
+    enqueue({std::move(path), std::move(contents), {}});
+}
+
+void BackgroundIo::post(std::function<void()> job) {
+    enqueue({{}, {}, std::move(job)});
+}
+
+void BackgroundIo::enqueue(Job job) {
+    {
+        std::lock_guard lock(m_mutex);
+        m_jobs.push_back(std::move(job));
+        ++m_queued;
+    }
+    m_wake.notify_one();
+}
+
+void BackgroundIo::flush() {
+    std::unique_lock lock(m_mutex);
+    const std::uint64_t target = m_queued;
+    m_idle.wait(lock, [this, target] { return m_done >= target; });
+}
+
+void BackgroundIo::syncDirectoryLater(const std::filesystem::path& dir) {
+    m_dirtyDirs.insert(dir);
+}
+
+void BackgroundIo::replace(const Job& job) {
+    std::error_code ec;
+    const std::filesystem::path dir = job.path.parent_path();
+    if (!dir.empty())
+        std::filesystem::create_directories(dir, ec);
+
+    const std::filesystem::path tmp = std::filesystem::path(job.path).concat(".tmp");
+    std::FILE* f = std::fopen(tmp.string().c_str(), "wb");
+    bool ok = f != nullptr;
+    if (f) {
+        ok = std::fwrite(job.contents.data(), 1, job.contents.size(), f) == job.contents.size() && syncFile(f);
+        std::fclose(f);
+    }
+    if (!ok || !replaceFile(tmp, job.path, false)) {
+        std::fprintf(stderr, "[Io] could not write '%s'\n", job.path.string().c_str());
+        std::filesystem::remove(tmp, ec);
+        return;
+    }
+    m_dirtyDirs.insert(dir);
+}
+
+void BackgroundIo::workerLoop() {
+    Trace::setThreadName("io writer");
+    std::vector<Job> batch;
+    for (;;) {
+        {
+            std::unique_lock lock(m_mutex);
+            m_wake.wait(lock, [this] { return m_stopping || !m_jobs.empty(); });
+            if (m_jobs.empty())
+                return; // stopping and drained
+            batch.assign(std::make_move_iterator(m_jobs.begin()), std::make_move_iterator(m_jobs.end()));
+            m_jobs.clear();
+        }
+
+        {
+            TETRIS_TRACE_SCOPE("io batch");
+            for (const Job& job : batch) {
+                if (job.run)
+                    job.run();
+                else
+                    replace(job);
+            }
+            // one directory sync per batch makes every rename in it durable
+            for (const auto& dir : m_dirtyDirs)
+                if (!syncDirectory(dir))
+                    std::fprintf(stderr, "[Io] could not sync '%s'\n", dir.string().c_str());
+            m_dirtyDirs.clear();
+        }
+
+        {
+            std::lock_guard lock(m_mutex);
+            m_done += batch.size();
+        }
+        m_idle.notify_all();
+        batch.clear();
+    }
+}
+
+} // namespace Tetris
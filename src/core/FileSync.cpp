@@ -0,0 +1,52 @@
+#include "core/FileSync.hpp"
+
+#include <system_error>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <io.h>
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace Tetris {
+
+bool syncFile(std::FILE* f) {
+    if (std::fflush(f) != 0)
+        return false;
+#ifdef _WIN32
+    return FlushFileBuffers(reinterpret_cast<HANDLE>(_get_osfhandle(_fileno(f)))) != 0;
+#else
+    return ::fsync(::fileno(f)) == 0;
+#endif
+}
+
+bool syncDirectory(const std::filesystem::path& dir) {
+#ifdef _WIN32
+    (void)dir;
+    return true;
+#else
+    const int fd = ::open(dir.empty() ? "." : dir.c_str(), O_RDONLY | O_DIRECTORY);
+    if (fd < 0)
+        return false;
+    const bool ok = ::fsync(fd) == 0;
+    ::close(fd);
+    return ok;
+#endif
+}
+
+bool replaceFile(const std::filesystem::path& tmp, const std::filesystem::path& target, bool syncDir) {
+#ifdef _WIN32
+    return MoveFileExW(tmp.c_str(), target.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    std::error_code ec;
+    std::filesystem::rename(tmp, target, ec);
+    return !ec && (!syncDir || syncDirectory(target.parent_path()));
+#endif
+}
+
+} // namespace Tetris
@@ -0,0 +1,143 @@
+#include "core/FramePacer.hpp"
+#include "core/Trace.hpp"
+
+#include <SFML/Window/Window.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <timeapi.h>
+#endif
+
+namespace Tetris {
+
+using namespace std::chrono_literals;
+
+// Sleep overshoot we start from, and the range the adaptive margin stays in.
+static constexpr auto kInitialMargin = 1ms;
+static constexpr auto kMinMargin     = 200us;
+static constexpr auto kMaxMargin     = 4ms;
+static constexpr auto kReportEvery   = 10s;
+
+const char* pacingModeName(PacingMode mode) {
+    switch (mode) {
+        case PacingMode::Capped:   return "cap";
+        case PacingMode::Uncapped: return "uncapped";
+        case PacingMode::VSync:    return "vsync";
+    }
+    return "?";
+}
+
+bool parsePacingMode(const char* name, PacingMode& out) {
+    for (auto mode : {PacingMode::Capped, PacingMode::Uncapped, PacingMode::VSync}) {
+        if (!std::strcmp(name, pacingModeName(mode))) {
+            out = mode;
+            return true;
+        }
+    }
+    return false;
+}
+
+FramePacer::FramePacer()
+    : m_sleepMargin(kInitialMargin)
+{
+#ifdef _WIN32
+    // default timer resolution is ~15.6 ms; ask for 1 ms while we run
+    timeBeginPeriod(1);
+#endif
+}
+
+FramePacer::~FramePacer() {
+#ifdef _WIN32
+    timeEndPeriod(1);
+#endif
+}
+
+void FramePacer::configure(sf::Window& window, const PacingSettings& settings) {
+    m_settings = settings;
+    window.setFramerateLimit(0);
+    window.setVerticalSyncEnabled(settings.mode == PacingMode::VSync);
+
+    const float fps = std::clamp(settings.fpsCap, 30.f, 1000.f);
+    m_period   = std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(1.0 / fps));
+    m_deadline = clock::now() + m_period;
+    m_error.reset();
+    m_missed     = 0;
+    m_lastReport = clock::now();
+
+    if (settings.mode == PacingMode::Capped)
+        std::fprintf(stderr, "[Pacer] cap %.0f fps (%.3f ms)\n", fps,
+                     std::chrono::duration<double, std::milli>(m_period).count());
+    else
+        std::fprintf(stderr, "[Pacer] %s\n", pacingModeName(settings.mode));
+}
+
+void FramePacer::wait() {
+    if (m_settings.mode != PacingMode::Capped)
+        return;
+
+    TETRIS_TRACE_SCOPE("pace");
+    auto now = clock::now();
+
+    if (now >= m_deadline) {
+        // the frame itself overran; nothing to pace
+        ++m_missed;
+        m_deadline += m_period;
+        if (now - m_deadline > m_period)
+            m_deadline = now + m_period; // hitch: restart the grid
+        if (now - m_lastReport >= kReportEvery)
+            report(now);
+        return;
+    }
+
+    // coarse: sleep while more than the margin remains
+    while (m_deadline - now > m_sleepMargin) {
+        const auto want = m_deadline - now - m_sleepMargin;
+        std::this_thread::sleep_for(want);
+        const auto after = clock::now();
+
+        // adapt: margin tracks the worst recent overshoot, decaying slowly
+        const auto overshoot = (after - now) - want;
+        m_sleepMargin = std::clamp<clock::duration>(
+            std::max<clock::duration>(overshoot + overshoot / 4, m_sleepMargin - m_sleepMargin / 64),
+            kMinMargin, kMaxMargin);
+        now = after;
+    }
+
+    // fine: spin on the clock
+    while (now < m_deadline)
+        now = clock::now();
+
+    const auto err = std::chrono::duration_cast<std::chrono::nanoseconds>(now - m_deadline).count();
+    m_error.add(static_cast<std::uint64_t>(err));
+
+    m_deadline += m_period;
+
+    if (now - m_lastReport >= kReportEvery)
+        report(now);
+}
+
+void FramePacer::report(clock::time_point now) {
+    if (m_error.count() > 0) {
+        auto us = [](std::uint64_t ns) { return static_cast<double>(ns) / 1000.0; };
+        std::fprintf(stderr,
+                     "[Pacer] %llu frames, %llu overran: error p50 %.1f us, p99 %.1f us, max %.1f us"
+                     " (sleep margin %.0f us)\n",
+                     static_cast<unsigned long long>(m_error.count()),
+                     static_cast<unsigned long long>(m_missed),
+                     us(m_error.percentileNs(0.50)), us(m_error.percentileNs(0.99)), us(m_error.maxNs()),
+                     std::chrono::duration<double, std::micro>(m_sleepMargin).count());
+    }
+    m_error.reset();
+    m_missed     = 0;
+    m_lastReport = now;
+}
+
+} // namespace Tetris
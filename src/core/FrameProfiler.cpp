@@ -0,0 +1,31 @@
+#include "core/FrameProfiler.hpp"
+
+namespace Tetris {
+
+const char* framePhaseName(FramePhase p) {
+    switch (p) {
+        case FramePhase::Events:  return "events";
+        case FramePhase::Update:  return "update";
+        case FramePhase::Render:  return "render";
+        case FramePhase::Display: return "display";
+        case FramePhase::Frame:   return "frame";
+        case FramePhase::Count:   break;
+    }
+    return "?";
+}
+
+std::uint64_t DurationHistogram::percentileNs(double q) const {
+    if (m_total == 0)
+        return 0;
+
+    const auto rank = static_cast<std::uint64_t>(q * static_cast<double>(m_total - 1)) + 1;
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < kBuckets; ++i) {
+        seen += m_counts[i];
+        if (seen >= rank)
+            return bucketMidNs(i) < m_max ? bucketMidNs(i) : m_max;
+    }
+    return m_max;
+}
+
+} // namespace Tetris
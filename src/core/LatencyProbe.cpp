@@ -0,0 +1,91 @@
+#include "core/LatencyProbe.hpp"
+
+#include <cstdio>
+#include <sstream>
+
+namespace Tetris {
+
+const char* latencyActionName(LatencyAction a) {
+    switch (a) {
+        case LatencyAction::Move:     return "move";
+        case LatencyAction::Rotate:   return "rotate";
+        case LatencyAction::HardDrop: return "hard drop";
+        case LatencyAction::Hold:     return "hold";
+        case LatencyAction::Count:    break;
+    }
+    return "?";
+}
+
+LatencyAction latencyActionOf(InputAction a) {
+    switch (a) {
+        case InputAction::Left:
+        case InputAction::Right:
+        case InputAction::SoftDrop:  return LatencyAction::Move;
+        case InputAction::RotateCW:
+        case InputAction::RotateCCW:
+        case InputAction::Rotate180: return LatencyAction::Rotate;
+        case InputAction::HardDrop:  return LatencyAction::HardDrop;
+        case InputAction::Hold:      return LatencyAction::Hold;
+    }
+    return LatencyAction::Move;
+}
+
+void LatencyProbe::track(std::uint32_t seq, InputAction action, clock::time_point arrived) {
+    if (!m_enabled || seq == 0)
+        return;
+    if (m_tail - m_head == kMaxPending)
+        ++m_head; // nothing displayed for a long time: forget the oldest
+    m_pending[m_tail % kMaxPending] = {seq, latencyActionOf(action), arrived};
+    ++m_tail;
+}
+
+void LatencyProbe::onDisplayed(std::uint32_t appliedSeq, clock::time_point displayed) {
+    while (m_head != m_tail) {
+        const Pending& p = m_pending[m_head % kMaxPending];
+        if (p.seq > appliedSeq)
+            break;
+
+        const auto lat = std::chrono::duration_cast<std::chrono::microseconds>(displayed - p.arrived).count();
+        m_hist[static_cast<std::size_t>(p.action)].add(static_cast<std::uint64_t>(lat) * 1000u);
+        m_samples.push_back({
+            p.seq, p.action,
+            std::chrono::duration_cast<std::chrono::microseconds>(p.arrived - m_epoch).count(),
+            lat
+        });
+        ++m_head;
+    }
+}
+
+void LatencyProbe::reset() {
+    dropPending();
+    for (auto& h : m_hist) h.reset();
+    m_samples.clear();
+    m_epoch = clock::now();
+}
+
+std::string LatencyProbe::summary() const {
+    std::string out = "input -> display (ms)";
+    char line[96];
+    for (std::size_t i = 0; i < kLatencyActionCount; ++i) {
+        const auto& h = m_hist[i];
+        if (h.count() == 0)
+            continue;
+        std::snprintf(line, sizeof(line), "\n%-9s p50 %5.2f  p99 %5.2f  n %llu",
+                      latencyActionName(static_cast<LatencyAction>(i)),
+                      static_cast<double>(h.percentileNs(0.50)) / 1e6,
+                      static_cast<double>(h.percentileNs(0.99)) / 1e6,
+                      static_cast<unsigned long long>(h.count()));
+        out += line;
+    }
+    return out;
+}
+
+std::string LatencyProbe::csv() const {
+    std::ostringstream out;
+    out << "seq,action,arrived_us,latency_us\n";
+    for (const auto& s : m_samples)
+        out << s.seq << ',' << latencyActionName(s.action) << ',' << s.arrivedUs << ',' << s.latencyUs << '\n';
+    return out.str();
+}
+
+} // namespace Tetris
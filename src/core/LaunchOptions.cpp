@@ -0,0 +1,58 @@
+#include "core/LaunchOptions.hpp"
+
+#include <cstdio>
+#include <cstring>
+
+namespace Tetris {
+
+static void printUsage(const char* exe) {
+    std::fprintf(stderr,
+                 "usage: %s [options]\n"
+                 "  --trace [file]   record a Chrome trace (default trace.json);\n"
+                 "                   written on exit or with F9\n"
+                 "  --telemetry [name]\n"
+                 "                   publish per-frame metrics to shared memory\n"
+                 "                   (default tetris_srs; read with telemetry_tail)\n"
+                 "  --latency        measure input-to-display latency; shown in the\n"
+                 "                   HUD, F7 / exit writes latency.csv\n"
+                 "  --practice <fumen|file>\n"
+                 "                   start on a fumen board (v115@..., or a file\n"
+                 "                   holding one); not recorded or scored\n",
+                 exe);
+}
+
+LaunchOptions parseLaunchOptions(int argc, char** argv) {
+    LaunchOptions opts;
+
+    // value of an optional argument, if the next token isn't another flag
+    auto optionalValue = [&](int& i) -> const char* {
+        if (i + 1 < argc && std::strncmp(argv[i + 1], "--", 2) != 0)
+            return argv[++i];
+        return nullptr;
+    };
+
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        if (!std::strcmp(arg, "--trace")) {
+            const char* v = optionalValue(i);
+            opts.tracePath = v ? v : "trace.json";
+        } else if (!std::strcmp(arg, "--telemetry")) {
+            const char* v = optionalValue(i);
+            opts.telemetryName = v ? v : "tetris_srs";
+        } else if (!std::strcmp(arg, "--latency")) {
+            opts.latency = true;
+        } else if (!std::strcmp(arg, "--practice")) {
+            if (const char* v = optionalValue(i))
+                opts.practice = v;
+            else
+                std::fprintf(stderr, "[Options] --practice needs a fumen or a file\n");
+        } else if (!std::strcmp(arg, "--help") || !std::strcmp(arg, "-h")) {
+            printUsage(argv[0]);
+        } else {
+            std::fprintf(stderr, "[Options] ignoring unknown argument: %s\n", arg);
+        }
+    }
+    return opts;
+}
+
+} // namespace Tetris
@@ -0,0 +1,133 @@
+#include "core/MappedFile.hpp"
+
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Tetris {
+
+MappedFile::MappedFile(MappedFile&& other) noexcept {
+    *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        m_data      = std::exchange(other.m_data, nullptr);
+        m_size      = std::exchange(other.m_size, 0);
+        m_openEmpty = std::exchange(other.m_openEmpty, false);
+#ifdef _WIN32
+        m_file      = std::exchange(other.m_file, nullptr);
+        m_mapping   = std::exchange(other.m_mapping, nullptr);
+#endif
+    }
+    return *this;
+}
+
+#ifdef _WIN32
+
+bool MappedFile::open(const std::filesystem::path& path) {
+    close();
+
+    // Share everything: the mapping is a reader like any other, and files
+    // such as ScoreStore's record log are appended to while mapped. (A file
+    // with a mapped view still can't be truncated or replaced.)
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ,
+                              FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER size{};
+    if (!GetFileSizeEx(file, &size)) {
+        CloseHandle(file);
+        return false;
+    }
+    if (size.QuadPart == 0) {
+        CloseHandle(file);
+        m_openEmpty = true;
+        return true;
+    }
+
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        CloseHandle(file);
+        return false;
+    }
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    m_file    = file;
+    m_mapping = mapping;
+    m_data    = static_cast<const unsigned char*>(view);
+    m_size    = static_cast<std::size_t>(size.QuadPart);
+    return true;
+}
+
+void MappedFile::close() {
+    if (m_data)    UnmapViewOfFile(m_data);
+    if (m_mapping) CloseHandle(static_cast<HANDLE>(m_mapping));
+    if (m_file)    CloseHandle(static_cast<HANDLE>(m_file));
+    m_data      = nullptr;
+    m_mapping   = nullptr;
+    m_file      = nullptr;
+    m_size      = 0;
+    m_openEmpty = false;
+}
+
+#else
+
+bool MappedFile::open(const std::filesystem::path& path) {
+    close();
+
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat st{};
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        return false;
+    }
+    if (st.st_size == 0) {
+        ::close(fd);
+        m_openEmpty = true;
+        return true;
+    }
+
+    void* view = ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // the mapping keeps its own reference
+    if (view == MAP_FAILED)
+        return false;
+
+    m_data = static_cast<const unsigned char*>(view);
+    m_size = static_cast<std::size_t>(st.st_size);
+    return true;
+}
+
+void MappedFile::close() {
+    if (m_data)
+        ::munmap(const_cast<unsigned char*>(m_data), m_size);
+    m_data      = nullptr;
+    m_size      = 0;
+    m_openEmpty = false;
+}
+
+#endif
+
+} // namespace Tetris
@@ -0,0 +1,86 @@
+#include "core/ReplayWriter.hpp"
+#include "core/FileSync.hpp"
+
+#include <system_error>
+
+namespace Tetris {
+
+void ReplayWriter::begin(std::filesystem::path path) {
+    m_file = std::make_shared<File>();
+    m_io.post([file = m_file, path = std::move(path)] {
+        std::error_code ec;
+        std::filesystem::create_directories(path.parent_path(), ec);
+        file->path = path;
+        file->part = std::filesystem::path(path).concat(".part");
+        file->out  = std::fopen(file->part.string().c_str(), "wb");
+        if (!file->out)
+            std::fprintf(stderr, "[Replay] could not create '%s'\n", file->part.string().c_str());
+    });
+}
+
+void ReplayWriter::append(std::vector<std::uint8_t> bytes) {
+    if (bytes.empty() || !m_file)
+        return;
+    bool queueDrain = false;
+    {
+        std::lock_guard lock(m_file->mutex);
+        if (m_file->dropped)
+            return;
+        if (m_file->pending.size() + bytes.size() > kMaxPendingBytes) {
+            m_file->dropped = true;
+            m_file->pending = {};
+            queueDrain = true; // which closes and removes the .part file
+        } else {
+            queueDrain = m_file->pending.empty(); // else a drain is already queued
+            m_file->pending.insert(m_file->pending.end(), bytes.begin(), bytes.end());
+        }
+    }
+    if (queueDrain)
+        m_io.post([file = m_file] { drain(*file); });
+}
+
+// Writer thread: write out everything appended so far.
+void ReplayWriter::drain(File& file) {
+    file.writing.clear();
+    bool dropped;
+    {
+        std::lock_guard lock(file.mutex);
+        file.writing.swap(file.pending);
+        dropped = file.dropped;
+    }
+    if (!file.out)
+        return;
+    if (dropped) {
+        std::fclose(file.out);
+        file.out = nullptr;
+        std::error_code ec;
+        std::filesystem::remove(file.part, ec);
+        std::fprintf(stderr, "[Replay] disk too slow, dropped '%s' after %ju bytes\n",
+                     file.path.string().c_str(), file.bytes);
+        return;
+    }
+    if (std::fwrite(file.writing.data(), 1, file.writing.size(), file.out) != file.writing.size())
+        file.failed = true;
+    file.bytes += file.writing.size();
+}
+
+void ReplayWriter::finish() {
+    if (!m_file)
+        return;
+    m_io.post([io = &m_io, file = std::move(m_file)] {
+        drain(*file);
+        if (!file->out)
+            return;
+        const bool synced = syncFile(file->out);
+        const bool closed = std::fclose(file->out) == 0;
+        file->out = nullptr;
+        if (file->failed || !synced || !closed || !replaceFile(file->part, file->path, false)) {
+            std::fprintf(stderr, "[Replay] write to '%s' failed\n", file->part.string().c_str());
+            return;
+        }
+        io->syncDirectoryLater(file->path.parent_path());
+        std::fprintf(stderr, "[Replay] saved %s (%ju bytes)\n", file->path.string().c_str(), file->bytes);
+    });
+}
+
+} // namespace Tetris
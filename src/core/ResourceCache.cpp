@@ -0,0 +1,121 @@
+#include "core/ResourceCache.hpp"
+#include "core/Trace.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+
+namespace fs = std::filesystem;
+
+namespace Tetris {
+
+ResourceCache::ResourceCache() {
+    try {
+        for (const char* candidate : {"resources.pak", "../resources.pak"}) {
+            if (!fs::exists(candidate)) continue;
+            auto pack = std::make_shared<ResourcePack>();
+            if (pack->open(candidate)) {
+                std::fprintf(stderr, "[Resources] using pack %s (%zu entries)\n",
+                             candidate, pack->entryCount());
+                m_pack = std::move(pack);
+                break;
+            }
+        }
+        for (const char* candidate : {"resources", "../resources"}) {
+            if (fs::is_directory(candidate)) {
+                m_looseRoot = candidate;
+                break;
+            }
+        }
+    } catch (...) {
+    }
+
+    if (!m_pack) {
+        std::fprintf(stderr, "[Resources] no resources.pak, loading loose files from %s\n",
+                     m_looseRoot.empty() ? "(none)" : m_looseRoot.string().c_str());
+    }
+}
+
+std::shared_ptr<const ResourceCache::Blob> ResourceCache::blob(const std::string& name) const {
+    if (m_pack) {
+        const auto bytes = m_pack->find(name);
+        if (!bytes.empty()) {
+            auto b = std::make_shared<Blob>();
+            b->pack  = m_pack;
+            b->bytes = bytes;
+            return b;
+        }
+    }
+
+    if (m_looseRoot.empty())
+        return nullptr;
+
+    std::ifstream in(m_looseRoot / name, std::ios::in | std::ios::binary);
+    if (!in)
+        return nullptr;
+
+    auto b = std::make_shared<Blob>();
+    b->owned.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    b->bytes = b->owned;
+    return b;
+}
+
+template<class T, class Load>
+std::shared_ptr<const T> ResourceCache::getOrLoad(SlotMap<T>& slots, const std::string& name, Load&& load) {
+    std::shared_ptr<Slot<T>> slot;
+    {
+        std::lock_guard lock(m_mutex);
+        auto& s = slots[name];
+        if (!s) s = std::make_shared<Slot<T>>();
+        slot = s;
+    }
+
+    // Other assets keep loading in parallel; only this name waits here.
+    std::lock_guard lock(slot->mutex);
+    if (auto alive = slot->value.lock())
+        return alive;
+
+    std::shared_ptr<const T> loaded = load(name);
+    if (loaded)
+        slot->value = loaded;
+    return loaded;
+}
+
+std::shared_ptr<const sf::Font> ResourceCache::font(const std::string& name) {
+    return getOrLoad(m_fonts, name, [this](const std::string& n) -> std::shared_ptr<const sf::Font> {
+        TETRIS_TRACE_SCOPE_CAT("load font", "assets");
+
+        // sf::Font reads from the memory for its whole lifetime, so the
+        // font and its bytes share one allocation.
+        struct Holder {
+            std::shared_ptr<const Blob> bytes;
+            sf::Font                    font;
+        };
+
+        auto h = std::make_shared<Holder>();
+        h->bytes = blob(n);
+        if (!h->bytes || !h->font.openFromMemory(h->bytes->bytes.data(), h->bytes->bytes.size())) {
+            std::fprintf(stderr, "[Resources] Failed to load font: %s\n", n.c_str());
+            return nullptr;
+        }
+        std::fprintf(stderr, "[Resources] Loaded font: %s\n", n.c_str());
+        return std::shared_ptr<const sf::Font>(h, &h->font);
+    });
+}
+
+std::shared_ptr<const sf::Image> ResourceCache::image(const std::string& name) {
+    return getOrLoad(m_images, name, [this](const std::string& n) -> std::shared_ptr<const sf::Image> {
+        TETRIS_TRACE_SCOPE_CAT("decode image", "assets");
+
+        const auto bytes = blob(n);
+        auto img = std::make_shared<sf::Image>();
+        if (!bytes || !img->loadFromMemory(bytes->bytes.data(), bytes->bytes.size())) {
+            std::fprintf(stderr, "[Resources] Failed to load image: %s\n", n.c_str());
+            return nullptr;
+        }
+        std::fprintf(stderr, "[Resources] Loaded image: %s\n", n.c_str());
+        return img;
+    });
+}
+
+} // namespace Tetris
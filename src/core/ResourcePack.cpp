@@ -0,0 +1,75 @@
+#include "core/ResourcePack.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+namespace Tetris {
+
+template<class T>
+static bool readPod(const unsigned char* base, std::size_t size, std::size_t& pos, T& out) {
+    if (size - pos < sizeof(T)) return false;
+    std::memcpy(&out, base + pos, sizeof(T));
+    pos += sizeof(T);
+    return true;
+}
+
+bool ResourcePack::open(const std::filesystem::path& path) {
+    m_entries.clear();
+    if (!m_file.open(path))
+        return false;
+
+    const unsigned char* base = m_file.data();
+    const std::size_t    size = m_file.size();
+
+    PakHeader hdr{};
+    std::size_t pos = 0;
+    if (!readPod(base, size, pos, hdr)
+        || std::memcmp(hdr.magic, kPakMagic, sizeof(kPakMagic)) != 0
+        || hdr.version != kPakVersion
+        || hdr.indexOffset > size
+        || hdr.indexSize > size - hdr.indexOffset) {
+        std::fprintf(stderr, "[Resources] %s is not a valid resource pack\n",
+                     path.string().c_str());
+        m_file.close();
+        return false;
+    }
+
+    const std::size_t indexEnd = static_cast<std::size_t>(hdr.indexOffset + hdr.indexSize);
+    pos = static_cast<std::size_t>(hdr.indexOffset);
+    m_entries.reserve(hdr.count);
+
+    for (std::uint32_t i = 0; i < hdr.count; ++i) {
+        Entry e{};
+        std::uint32_t nameLen = 0;
+        if (!readPod(base, indexEnd, pos, e.offset)
+            || !readPod(base, indexEnd, pos, e.size)
+            || !readPod(base, indexEnd, pos, nameLen)
+            || indexEnd - pos < nameLen
+            || e.offset > size || e.size > size - e.offset) {
+            std::fprintf(stderr, "[Resources] %s: corrupt index entry %u\n",
+                         path.string().c_str(), i);
+            m_entries.clear();
+            m_file.close();
+            return false;
+        }
+        e.name = std::string_view(reinterpret_cast<const char*>(base + pos), nameLen);
+        pos += nameLen;
+        m_entries.push_back(e);
+    }
+
+    // the packer writes a sorted index, but don't trust it blindly
+    std::sort(m_entries.begin(), m_entries.end(),
+              [](const Entry& a, const Entry& b) { return a.name < b.name; });
+    return true;
+}
+
+std::span<const unsigned char> ResourcePack::find(std::string_view name) const {
+    auto it = std::lower_bound(m_entries.begin(), m_entries.end(), name,
+                               [](const Entry& e, std::string_view n) { return e.name < n; });
+    if (it == m_entries.end() || it->name != name)
+        return {};
+    return {m_file.data() + it->offset, static_cast<std::size_t>(it->size)};
+}
+
+} // namespace Tetris
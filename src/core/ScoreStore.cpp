@@ -0,0 +1,439 @@
+#include "core/ScoreStore.hpp"
+#include "core/FileSync.hpp"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <span>
+#include <string_view>
+#include <system_error>
+
+namespace Tetris {
+
+namespace fs = std::filesystem;
+
+static constexpr char          kDataMagic[8]  = {'T', 'S', 'R', 'S', 'S', 'C', 'R', '\0'};
+static constexpr char          kIndexMagic[8] = {'T', 'S', 'R', 'S', 'S', 'I', 'X', '\0'};
+static constexpr std::uint32_t kStoreVersion   = 1;
+static constexpr std::size_t   kDataHeader     = 16;
+static constexpr std::size_t   kRecordSize     = 96;
+static constexpr std::size_t   kIndexHeader    = 32;
+static constexpr std::size_t   kIndexEntry     = 16;
+static constexpr std::size_t   kReplayNameSize = 56;
+
+// ---- encoding ---------------------------------------------------------------
+
+static std::uint32_t crc32(const unsigned char* p, std::size_t n) {
+    static const auto table = [] {
+        std::array<std::uint32_t, 256> t{};
+        for (std::uint32_t i = 0; i < 256; ++i) {
+            std::uint32_t c = i;
+            for (int k = 0; k < 8; ++k) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            t[i] = c;
+        }
+        return t;
+    }();
+    std::uint32_t c = 0xFFFFFFFFu;
+    for (std::size_t i = 0; i < n; ++i) c = table[(c ^ p[i]) & 0xFF] ^ (c >> 8);
+    return c ^ 0xFFFFFFFFu;
+}
+
+static void putLE(unsigned char* p, std::uint64_t v, int n) {
+    for (int i = 0; i < n; ++i) p[i] = static_cast<unsigned char>(v >> (8 * i));
+}
+
+static std::uint64_t getLE(const unsigned char* p, int n) {
+    std::uint64_t v = 0;
+    for (int i = 0; i < n; ++i) v |= std::uint64_t{p[i]} << (8 * i);
+    return v;
+}
+
+//   0 u32 crc of bytes 4..95   4 u8 run   5 u8 flags   6 u16 reserved
+//   8 u32 lines   12 u32 pieces   16 i64 timeUs   24 i64 date   32 u64 seed
+//  40 char[56] replay name, NUL padded
+static void encodeRecord(const ScoreRecord& r, unsigned char* out) {
+    std::memset(out, 0, kRecordSize);
+    out[4] = static_cast<unsigned char>(r.run);
+    out[5] = r.finished ? 1 : 0;
+    putLE(out + 8,  r.lines, 4);
+    putLE(out + 12, r.pieces, 4);
+    putLE(out + 16, static_cast<std::uint64_t>(r.timeUs), 8);
+    putLE(out + 24, static_cast<std::uint64_t>(r.dateUnix), 8);
+    putLE(out + 32, r.seed, 8);
+    std::memcpy(out + 40, r.replay.data(), std::min(r.replay.size(), kReplayNameSize - 1));
+    putLE(out, crc32(out + 4, kRecordSize - 4), 4);
+}
+
+static bool decodeRecord(const unsigned char* in, ScoreRecord& r) {
+    if (getLE(in, 4) != crc32(in + 4, kRecordSize - 4) || in[4] > static_cast<unsigned char>(RunType::Blitz))
+        return false;
+    r.run      = static_cast<RunType>(in[4]);
+    r.finished = (in[5] & 1) != 0;
+    r.lines    = static_cast<std::uint32_t>(getLE(in + 8, 4));
+    r.pieces   = static_cast<std::uint32_t>(getLE(in + 12, 4));
+    r.timeUs   = static_cast<std::int64_t>(getLE(in + 16, 8));
+    r.dateUnix = static_cast<std::int64_t>(getLE(in + 24, 8));
+    r.seed     = getLE(in + 32, 8);
+    const char* name = reinterpret_cast<const char*>(in + 40);
+    r.replay.assign(name, strnlen(name, kReplayNameSize));
+    return true;
+}
+
+std::uint64_t ScoreStore::rankKey(const ScoreRecord& r) {
+    const std::uint64_t missing = 0xFFFFFFFFull - r.lines; // more lines first
+    if (r.run == RunType::Sprint) {
+        if (r.finished)
+            return static_cast<std::uint64_t>(std::clamp<std::int64_t>(r.timeUs, 0, (std::int64_t{1} << 62) - 1));
+        return (std::uint64_t{1} << 62) + missing;
+    }
+    const auto ms = static_cast<std::uint64_t>(std::clamp<std::int64_t>(r.timeUs / 1000, 0, 0xFFFFFFFF));
+    return (missing << 32) | ms;
+}
+
+// ---- open -------------------------------------------------------------------
+
+bool ScoreStore::open(const fs::path& dir, RunType run) {
+    *this = ScoreStore{};
+    m_run       = run;
+    m_dataPath  = dir / (std::string(runTypeName(run)) + ".scores");
+    m_indexPath = dir / (std::string(runTypeName(run)) + ".index");
+
+    std::error_code ec;
+    if (!fs::exists(m_dataPath, ec)) {
+        fs::create_directories(dir, ec);
+        const fs::path legacy = dir / (run == RunType::Sprint ? std::string("sprint40.jsonl")
+                                                              : std::string(runTypeName(run)) + ".jsonl");
+        if (!create(fs::exists(legacy, ec) ? legacy : fs::path{}))
+            return false;
+    }
+
+    if (!loadData())
+        return false;
+    m_open = true;
+    return true;
+}
+
+// A new data file, with the old log's runs already in it, is written beside
+// the real one and renamed into place: a crash or a failed import leaves no
+// data file, so the next open() simply starts over.
+bool ScoreStore::create(const fs::path& legacy) {
+    const fs::path tmp = fs::path(m_dataPath).concat(".tmp");
+    std::FILE* f = std::fopen(tmp.string().c_str(), "wb");
+    if (!f) {
+        std::fprintf(stderr, "[Scores] could not create '%s'\n", tmp.string().c_str());
+        return false;
+    }
+    unsigned char hdr[kDataHeader] = {};
+    std::memcpy(hdr, kDataMagic, sizeof(kDataMagic));
+    putLE(hdr + 8, kStoreVersion, 4);
+    putLE(hdr + 12, kRecordSize, 4);
+    bool ok = std::fwrite(hdr, 1, sizeof(hdr), f) == sizeof(hdr);
+    if (ok && !legacy.empty() && !importJsonl(legacy, f)) {
+        std::fprintf(stderr, "[Scores] importing %s failed, will retry next time\n", legacy.string().c_str());
+        ok = false;
+    }
+    ok = ok && syncFile(f);
+    std::fclose(f);
+
+    std::error_code ec;
+    fs::remove(m_indexPath, ec); // would describe some other data file
+    if (!ok || !replaceFile(tmp, m_dataPath)) {
+        fs::remove(tmp, ec);
+        return false;
+    }
+    return true;
+}
+
+bool ScoreStore::loadData() {
+    std::error_code ec;
+    const auto size = fs::file_size(m_dataPath, ec);
+    if (ec || size < kDataHeader)
+        return false;
+
+    // a crash mid-append can leave part of a record: cut it off so the
+    // next append starts on a record boundary
+    m_records = (size - kDataHeader) / kRecordSize;
+    const std::uintmax_t whole = kDataHeader + m_records * kRecordSize;
+    if (whole != size) {
+        std::fprintf(stderr, "[Scores] %s: dropping a torn record\n", m_dataPath.string().c_str());
+        fs::resize_file(m_dataPath, whole, ec);
+    }
+
+    if (!m_data.open(m_dataPath) || m_data.size() < kDataHeader
+        || std::memcmp(m_data.data(), kDataMagic, sizeof(kDataMagic)) != 0
+        || getLE(m_data.data() + 8, 4) != kStoreVersion
+        || getLE(m_data.data() + 12, 4) != kRecordSize) {
+        std::fprintf(stderr, "[Scores] %s is not a score file\n", m_dataPath.string().c_str());
+        m_data.close();
+        return false;
+    }
+    return loadIndex();
+}
+
+bool ScoreStore::loadIndex() {
+    m_tail.clear();
+    m_indexCount = 0;
+
+    std::uint64_t covered = 0;
+    if (m_index.open(m_indexPath) && m_index.size() >= kIndexHeader) {
+        const unsigned char* h = m_index.data();
+        const std::uint64_t count = getLE(h + 16, 8);
+        covered = getLE(h + 24, 8);
+        const bool valid = std::memcmp(h, kIndexMagic, sizeof(kIndexMagic)) == 0
+                        && getLE(h + 8, 4) == kStoreVersion
+                        && getLE(h + 12, 4) == kIndexEntry
+                        && count <= (m_index.size() - kIndexHeader) / kIndexEntry
+                        && covered <= m_records
+                        && kDataHeader + covered * kRecordSize <= m_data.size();
+        if (valid) {
+            m_indexCount = static_cast<std::size_t>(count);
+        } else {
+            std::fprintf(stderr, "[Scores] %s is damaged, rebuilding\n", m_indexPath.string().c_str());
+            covered = 0;
+        }
+    }
+
+    // everything after the index is the in-memory tail
+    std::vector<unsigned char> rec(kRecordSize);
+    std::ifstream in(m_dataPath, std::ios::in | std::ios::binary);
+    in.seekg(static_cast<std::streamoff>(kDataHeader + covered * kRecordSize));
+    for (std::uint64_t i = covered; i < m_records; ++i) {
+        if (!in.read(reinterpret_cast<char*>(rec.data()), static_cast<std::streamsize>(kRecordSize)))
+            break;
+        ScoreRecord r;
+        if (decodeRecord(rec.data(), r))
+            m_tail.push_back({rankKey(r), i, std::move(r)});
+    }
+    std::sort(m_tail.begin(), m_tail.end(), [](const TailEntry& a, const TailEntry& b) {
+        return a.key != b.key ? a.key < b.key : a.ordinal < b.ordinal;
+    });
+
+    if (m_tail.size() > kMaxTail)
+        return compact();
+    return true;
+}
+
+// ---- writes -----------------------------------------------------------------
+
+bool ScoreStore::appendRecord(const ScoreRecord& r) {
+    std::FILE* f = std::fopen(m_dataPath.string().c_str(), "ab");
+    if (!f)
+        return false;
+    unsigned char buf[kRecordSize];
+    encodeRecord(r, buf);
+    const bool ok = std::fwrite(buf, 1, kRecordSize, f) == kRecordSize && syncFile(f);
+    std::fclose(f);
+    return ok;
+}
+
+bool ScoreStore::add(const ScoreRecord& record) {
+    if (!m_open)
+        return false;
+    ScoreRecord r = record;
+    r.run = m_run;
+    if (!appendRecord(r)) {
+        std::fprintf(stderr, "[Scores] write to '%s' failed\n", m_dataPath.string().c_str());
+        return false;
+    }
+
+    TailEntry e{rankKey(r), m_records++, std::move(r)};
+    const auto at = std::upper_bound(m_tail.begin(), m_tail.end(), e, [](const TailEntry& a, const TailEntry& b) {
+        return a.key < b.key;
+    });
+    m_tail.insert(at, std::move(e));
+
+    if (m_tail.size() > kMaxTail)
+        return compact();
+    return true;
+}
+
+bool ScoreStore::compact() {
+    if (!m_data.isOpen())
+        return false;
+
+    // merge the mapped index with the tail straight into the new file
+    const fs::path tmp = fs::path(m_indexPath).concat(".tmp");
+    std::FILE* f = std::fopen(tmp.string().c_str(), "wb");
+    if (!f)
+        return false;
+
+    unsigned char hdr[kIndexHeader] = {};
+    std::memcpy(hdr, kIndexMagic, sizeof(kIndexMagic));
+    putLE(hdr + 8,  kStoreVersion, 4);
+    putLE(hdr + 12, kIndexEntry, 4);
+    putLE(hdr + 16, m_indexCount + m_tail.size(), 8);
+    putLE(hdr + 24, m_records, 8);
+    bool ok = std::fwrite(hdr, 1, sizeof(hdr), f) == sizeof(hdr);
+
+    std::size_t i = 0, t = 0;
+    unsigned char entry[kIndexEntry];
+    while (ok && (i < m_indexCount || t < m_tail.size())) {
+        const bool fromIndex = t == m_tail.size()
+                            || (i < m_indexCount && indexKey(i) <= m_tail[t].key);
+        if (fromIndex) {
+            std::memcpy(entry, m_index.data() + kIndexHeader + i * kIndexEntry, kIndexEntry);
+            ++i;
+        } else {
+            putLE(entry,     m_tail[t].key, 8);
+            putLE(entry + 8, m_tail[t].ordinal, 8);
+            ++t;
+        }
+        ok = std::fwrite(entry, 1, kIndexEntry, f) == kIndexEntry;
+    }
+    ok = ok && syncFile(f);
+    std::fclose(f);
+
+    m_index.close(); // Windows can't replace a mapped file
+    if (!ok || !replaceFile(tmp, m_indexPath)) {
+        std::fprintf(stderr, "[Scores] compacting '%s' failed\n", m_indexPath.string().c_str());
+        std::error_code ec;
+        fs::remove(tmp, ec);
+        m_index.open(m_indexPath);
+        return false;
+    }
+    return m_data.open(m_dataPath) && loadIndex();
+}
+
+// ---- queries ----------------------------------------------------------------
+
+std::uint64_t ScoreStore::indexKey(std::size_t i) const {
+    return getLE(m_index.data() + kIndexHeader + i * kIndexEntry, 8);
+}
+
+std::optional<ScoreRecord> ScoreStore::indexed(std::size_t i) const {
+    const std::uint64_t ordinal = getLE(m_index.data() + kIndexHeader + i * kIndexEntry + 8, 8);
+    const std::uint64_t offset  = kDataHeader + ordinal * kRecordSize;
+    ScoreRecord r;
+    if (offset + kRecordSize > m_data.size() || !decodeRecord(m_data.data() + offset, r))
+        return std::nullopt;
+    return r;
+}
+
+std::vector<ScoreRecord> ScoreStore::top(std::size_t k) const {
+    std::vector<ScoreRecord> out;
+    std::size_t i = 0, t = 0;
+    while (out.size() < k && (i < m_indexCount || t < m_tail.size())) {
+        if (t == m_tail.size() || (i < m_indexCount && indexKey(i) <= m_tail[t].key)) {
+            if (auto r = indexed(i++))
+                out.push_back(std::move(*r));
+        } else {
+            out.push_back(m_tail[t++].record);
+        }
+    }
+    return out;
+}
+
+std::optional<ScoreRecord> ScoreStore::best() const {
+    auto t = top(1);
+    if (t.empty())
+        return std::nullopt;
+    return std::move(t.front());
+}
+
+std::size_t ScoreStore::rank(const ScoreRecord& record) const {
+    ScoreRecord r = record;
+    r.run = m_run;
+    const std::uint64_t key = rankKey(r);
+
+    // binary search over the mapped index
+    std::size_t lo = 0, hi = m_indexCount;
+    while (lo < hi) {
+        const std::size_t mid = lo + (hi - lo) / 2;
+        if (indexKey(mid) < key) lo = mid + 1;
+        else                     hi = mid;
+    }
+    const auto tail = std::lower_bound(m_tail.begin(), m_tail.end(), key,
+                                       [](const TailEntry& e, std::uint64_t k) { return e.key < k; });
+    return lo + static_cast<std::size_t>(tail - m_tail.begin());
+}
+
+double ScoreStore::percentile(const ScoreRecord& record) const {
+    const std::size_t n = size();
+    if (n == 0)
+        return 100.0;
+    return 100.0 * static_cast<double>(n - rank(record)) / static_cast<double>(n);
+}
+
+// ---- import -----------------------------------------------------------------
+
+// One object per line. Recognised keys: "timeUs", "timeMs" or "time"
+// (seconds), "lines", "pieces", "date" / "timestamp" (unix), "seed",
+// "replay". A Sprint line without "lines" counts as a finished 40. The
+// records are written to `out`; false on a read or write error.
+bool ScoreStore::importJsonl(const fs::path& path, std::FILE* out) {
+    std::ifstream in(path);
+    if (!in)
+        return false;
+
+    const auto number = [](std::string_view line, const char* key, double& out) {
+        const std::string pattern = std::string("\"") + key + "\"";
+        std::size_t pos = line.find(pattern);
+        if (pos == std::string_view::npos || (pos = line.find(':', pos)) == std::string_view::npos)
+            return false;
+        const std::string rest(line.substr(pos + 1, 32));
+        char* end = nullptr;
+        const double v = std::strtod(rest.c_str(), &end);
+        if (end == rest.c_str())
+            return false;
+        out = v;
+        return true;
+    };
+    // seeds use all 64 bits, more than a double holds exactly
+    const auto integer = [](std::string_view line, const char* key, std::uint64_t& out) {
+        const std::string pattern = std::string("\"") + key + "\"";
+        std::size_t pos = line.find(pattern);
+        if (pos == std::string_view::npos || (pos = line.find(':', pos)) == std::string_view::npos)
+            return false;
+        pos = line.find_first_not_of(" \t\"", pos + 1); // also "seed": "123"
+        if (pos == std::string_view::npos)
+            return false;
+        return std::from_chars(line.data() + pos, line.data() + line.size(), out).ec == std::errc{};
+    };
+
+    unsigned char rec[kRecordSize];
+
+    std::size_t imported = 0, skipped = 0;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.find('{') == std::string::npos)
+            continue;
+
+        ScoreRecord r;
+        r.run = m_run;
+        double v = 0.0;
+        if (number(line, "timeUs", v))      r.timeUs = static_cast<std::int64_t>(v);
+        else if (number(line, "timeMs", v)) r.timeUs = static_cast<std::int64_t>(v * 1e3);
+        else if (number(line, "time", v))   r.timeUs = static_cast<std::int64_t>(v * 1e6);
+        else { ++skipped; continue; }
+
+        r.lines = number(line, "lines", v) ? static_cast<std::uint32_t>(v) : (m_run == RunType::Sprint ? 40u : 0u);
+        if (number(line, "pieces", v)) r.pieces = static_cast<std::uint32_t>(v);
+        if (number(line, "date", v) || number(line, "timestamp", v)) r.dateUnix = static_cast<std::int64_t>(v);
+        integer(line, "seed", r.seed);
+        r.finished = m_run == RunType::Sprint ? r.lines >= 40 : true;
+
+        if (const std::size_t key = line.find("\"replay\""); key != std::string::npos) {
+            const std::size_t open  = line.find('"', line.find(':', key));
+            const std::size_t close = open == std::string::npos ? open : line.find('"', open + 1);
+            if (close != std::string::npos)
+                r.replay = line.substr(open + 1, close - open - 1);
+        }
+
+        encodeRecord(r, rec);
+        if (std::fwrite(rec, 1, kRecordSize, out) != kRecordSize)
+            return false;
+        ++imported;
+    }
+    if (in.bad())
+        return false;
+    if (imported + skipped > 0)
+        std::fprintf(stderr, "[Scores] imported %zu runs from %s (%zu unreadable lines)\n",
+                     imported, path.string().c_str(), skipped);
+    return true;
+}
+
+} // namespace Tetris
@@ -0,0 +1,162 @@
+#include "core/SimulationThread.hpp"
+#include "core/Trace.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
+
+namespace Tetris {
+
+void SimulationThread::start(RunType run, const MoveSettings& settings, std::uint64_t seed,
+                             const std::filesystem::path& replayPath,
+                             const std::filesystem::path& racePath,
+                             const Simulation::Checkpoint* setup) {
+    stop();
+
+    m_sim.reset(run, settings, seed);
+    if (setup)
+        m_sim.restore(*setup);
+    m_inputs.clear();
+
+    m_racing   = false;
+    m_racePath = racePath; // opened on the simulation thread: no disk access here
+
+    if (!replayPath.empty() && !setup) {
+        ReplayHeader header;
+        header.runType     = run;
+        header.settings    = settings;
+        header.seed        = seed;
+        header.startedUnix = static_cast<std::int64_t>(std::time(nullptr));
+        m_recorder.begin(header);
+        m_replayOut.begin(replayPath);
+    }
+
+    publish(); // first frame of the run is valid before the thread is up
+
+    m_runStart = clock::now();
+    m_stop.store(false, std::memory_order_relaxed);
+    m_thread = std::thread([this] { threadMain(); });
+}
+
+void SimulationThread::stop() {
+    if (!m_thread.joinable())
+        return;
+    m_stop.store(true, std::memory_order_relaxed);
+    m_thread.join();
+    finishReplay();
+}
+
+void SimulationThread::finishReplay() {
+    if (!m_recorder.active())
+        return;
+
+    const GameState& s = m_sim.state();
+    ReplayResult r;
+    r.endTimeUs    = m_sim.timeUs();
+    r.lines        = static_cast<std::uint32_t>(s.totalLinesCleared);
+    r.pieces       = static_cast<std::uint32_t>(s.piecesPlaced);
+    r.sprintTimeUs = s.sprintTimeUs;
+    r.gameOver     = s.gameOver;
+    m_recorder.end(r);
+    m_replayOut.append(m_recorder.takeChunk());
+    m_replayOut.finish();
+}
+
+std::uint32_t SimulationThread::post(InputAction action, bool pressed, clock::time_point arrived) {
+    InputEvent in;
+    in.action  = action;
+    in.pressed = pressed;
+    in.timeUs  = std::chrono::duration_cast<std::chrono::microseconds>(arrived - m_runStart).count();
+    in.seq     = m_nextSeq;
+    if (m_inputs.tryPush(in))
+        return m_nextSeq++;
+    std::fprintf(stderr, "[Simulation] input queue full, dropped an event\n");
+    return 0;
+}
+
+void SimulationThread::publish() {
+    RenderSnapshot& out = m_snapshots.back();
+    m_sim.snapshot(out);
+    if (m_racing)
+        fillRaceSnapshot(m_race.sim().state(), out.race);
+    else
+        out.race.shown = false;
+    m_snapshots.publish();
+}
+
+void SimulationThread::openRace() {
+    // mapped, decoded a record at a time as the race goes on
+    m_racing = m_raceFile.open(m_racePath)
+            && m_race.open({m_raceFile.data(), m_raceFile.size()})
+            && m_race.decoder().header().runType == m_sim.state().runType;
+    if (!m_racing) {
+        std::fprintf(stderr, "[Simulation] can't race '%s'\n", m_racePath.string().c_str());
+        m_raceFile.close();
+    }
+}
+
+void SimulationThread::threadMain() {
+    Trace::setThreadName("simulation");
+    if (!m_racePath.empty())
+        openRace(); // the first ticks catch up on the time this takes
+
+    const auto tick = std::chrono::microseconds(kTickUs);
+    auto next = m_runStart + tick;
+    std::int64_t nextUs    = kTickUs; // simulation time at the end of the next tick
+    std::int64_t skippedUs = 0;       // wall time dropped after long stalls
+
+    while (!m_stop.load(std::memory_order_relaxed)) {
+        std::this_thread::sleep_until(next);
+
+        TETRIS_TRACE_SCOPE_CAT("sim ticks", "game");
+        int ticks = 0;
+        while (clock::now() >= next && ticks < kMaxCatchUpTicks) {
+            // inputs that arrived up to the end of this tick, in order, each
+            // at its own timestamp. Events stamped before the simulation's
+            // current time (the window thread polled late) apply immediately.
+            while (const InputEvent* in = m_inputs.front()) {
+                InputEvent ev = *in;
+                ev.timeUs -= skippedUs;
+                if (ev.timeUs > nextUs)
+                    break;
+                ev.timeUs = std::max(ev.timeUs, m_sim.timeUs());
+                m_sim.advanceTo(ev.timeUs);
+                if (!m_sim.state().gameOver)
+                    m_recorder.record(ev);
+                m_sim.apply(ev);
+                m_inputs.pop();
+            }
+            m_sim.advanceTo(nextUs);
+            if (m_racing)
+                m_race.advanceTo(nextUs);
+
+            next   += tick;
+            nextUs += kTickUs;
+            ++ticks;
+        }
+        if (ticks == kMaxCatchUpTicks && clock::now() >= next) {
+            // stalled too long (debugger, window drag): drop the rest of the
+            // backlog instead of fast-forwarding the game through it
+            const auto skipped = (clock::now() - next) / tick + 1;
+            next      += skipped * tick;
+            skippedUs += skipped * kTickUs;
+        }
+
+        if (m_recorder.active()) {
+            if (m_sim.state().gameOver) {
+                finishReplay(); // topped out or finished: the replay is complete
+            } else {
+                m_recorder.keyframeIfDue(m_sim);
+                if (m_recorder.pending() >= ReplayWriter::kChunkBytes)
+                    m_replayOut.append(m_recorder.takeChunk());
+            }
+        }
+
+        if (ticks > 0) {
+            publish();
+            m_ticks.fetch_add(static_cast<std::uint32_t>(ticks), std::memory_order_relaxed);
+        }
+    }
+}
+
+} // namespace Tetris
@@ -0,0 +1,39 @@
+#include "core/StartupReport.hpp"
+
+#include <algorithm>
+#include <cstdio>
+
+namespace Tetris {
+
+static double msBetween(StartupReport::clock::time_point a,
+                        StartupReport::clock::time_point b) {
+    return std::chrono::duration<double, std::milli>(b - a).count();
+}
+
+void StartupReport::add(std::string name, clock::time_point start, clock::time_point end) {
+    std::lock_guard lock(m_mutex);
+    m_entries.push_back(Entry{std::move(name), start, end});
+}
+
+void StartupReport::print(clock::time_point firstFrame) {
+    std::lock_guard lock(m_mutex);
+    if (m_printed)
+        return;
+    m_printed = true;
+
+    std::sort(m_entries.begin(), m_entries.end(),
+              [](const Entry& a, const Entry& b) { return a.start < b.start; });
+
+    std::fprintf(stderr, "[Startup] %-28s %9s %9s %9s\n", "phase", "ms", "from", "to");
+    for (const auto& e : m_entries) {
+        std::fprintf(stderr, "[Startup] %-28s %9.2f %9.2f %9.2f\n",
+                     e.name.c_str(),
+                     msBetween(e.start, e.end),
+                     msBetween(m_origin, e.start),
+                     msBetween(m_origin, e.end));
+    }
+    std::fprintf(stderr, "[Startup] time to first frame: %.2f ms\n",
+                 msBetween(m_origin, firstFrame));
+}
+
+} // namespace Tetris
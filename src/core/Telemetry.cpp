@@ -0,0 +1,154 @@
+#include "core/Telemetry.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <new>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Tetris {
+
+#ifdef _WIN32
+
+static std::wstring mappingName(const std::string& name) {
+    std::wstring w = L"Local\\";
+    w.append(name.begin(), name.end());
+    return w;
+}
+
+bool SharedMemory::create(const std::string& name, std::size_t size) {
+    close();
+    const auto w = mappingName(name);
+    HANDLE h = CreateFileMappingW(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                                  static_cast<DWORD>(static_cast<std::uint64_t>(size) >> 32),
+                                  static_cast<DWORD>(size), w.c_str());
+    if (!h) return false;
+    void* view = MapViewOfFile(h, FILE_MAP_ALL_ACCESS, 0, 0, size);
+    if (!view) { CloseHandle(h); return false; }
+    m_handle = h; m_data = view; m_size = size; m_owner = true; m_name = name;
+    return true;
+}
+
+bool SharedMemory::openReadOnly(const std::string& name) {
+    close();
+    const auto w = mappingName(name);
+    HANDLE h = OpenFileMappingW(FILE_MAP_READ, FALSE, w.c_str());
+    if (!h) return false;
+    void* view = MapViewOfFile(h, FILE_MAP_READ, 0, 0, 0);
+    if (!view) { CloseHandle(h); return false; }
+    MEMORY_BASIC_INFORMATION info{};
+    VirtualQuery(view, &info, sizeof(info));
+    m_handle = h; m_data = view; m_size = info.RegionSize; m_owner = false; m_name = name;
+    return true;
+}
+
+void SharedMemory::close() {
+    if (m_data)   UnmapViewOfFile(m_data);
+    if (m_handle) CloseHandle(static_cast<HANDLE>(m_handle));
+    m_data = nullptr; m_handle = nullptr; m_size = 0; m_owner = false; m_name.clear();
+}
+
+#else
+
+static std::string shmName(const std::string& name) {
+    return name.empty() || name[0] != '/' ? "/" + name : name;
+}
+
+bool SharedMemory::create(const std::string& name, std::size_t size) {
+    close();
+    const auto n = shmName(name);
+    const int fd = ::shm_open(n.c_str(), O_CREAT | O_RDWR, 0644);
+    if (fd < 0) return false;
+    if (::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        ::close(fd);
+        return false;
+    }
+    void* view = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (view == MAP_FAILED) return false;
+    m_data = view; m_size = size; m_owner = true; m_name = n;
+    return true;
+}
+
+bool SharedMemory::openReadOnly(const std::string& name) {
+    close();
+    const auto n = shmName(name);
+    const int fd = ::shm_open(n.c_str(), O_RDONLY, 0);
+    if (fd < 0) return false;
+    struct stat st{};
+    if (::fstat(fd, &st) != 0 || st.st_size == 0) {
+        ::close(fd);
+        return false;
+    }
+    void* view = ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (view == MAP_FAILED) return false;
+    m_data = view; m_size = static_cast<std::size_t>(st.st_size); m_owner = false; m_name = n;
+    return true;
+}
+
+void SharedMemory::close() {
+    if (m_data) ::munmap(m_data, m_size);
+    if (m_owner) ::shm_unlink(m_name.c_str()); // readers keep their mapping
+    m_data = nullptr; m_size = 0; m_owner = false; m_name.clear();
+}
+
+#endif
+
+bool TelemetryPublisher::open(const std::string& name, std::uint32_t capacity) {
+    m_header = nullptr;
+    if (capacity == 0 || !m_shm.create(name, telemetryMappingSize(capacity))) {
+        std::fprintf(stderr, "[Telemetry] could not create shared memory '%s'\n", name.c_str());
+        return false;
+    }
+
+    // fresh segment: construct header + slots in place, magic last
+    std::memset(m_shm.data(), 0, m_shm.size());
+    auto* h = new (m_shm.data()) TelemetryHeader{};
+    h->version    = kTelemetryVersion;
+    h->capacity   = capacity;
+    h->sampleSize = sizeof(TelemetrySample);
+    h->writeIndex.store(0, std::memory_order_relaxed);
+    auto* slots = telemetrySlots(h);
+    for (std::uint32_t i = 0; i < capacity; ++i)
+        new (&slots[i].seq) std::atomic<std::uint64_t>(0);
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(h->magic, kTelemetryMagic, sizeof(kTelemetryMagic));
+
+    m_header = h;
+    m_next   = 0;
+    std::fprintf(stderr, "[Telemetry] publishing to shared memory '%s' (%u slots)\n",
+                 name.c_str(), capacity);
+    return true;
+}
+
+void TelemetryPublisher::publish(const TelemetrySample& sample) {
+    if (!m_header)
+        return;
+
+    const std::uint64_t idx = m_next++;
+    TelemetrySlot& slot = telemetrySlots(m_header)[idx % m_header->capacity];
+
+    std::uint64_t words[kTelemetryWords];
+    std::memcpy(words, &sample, sizeof(words));
+
+    slot.seq.store(2 * idx + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (std::size_t i = 0; i < kTelemetryWords; ++i)
+        std::atomic_ref<std::uint64_t>(slot.words[i]).store(words[i], std::memory_order_relaxed);
+    slot.seq.store(2 * idx + 2, std::memory_order_release);
+
+    m_header->writeIndex.store(idx + 1, std::memory_order_release);
+}
+
+} // namespace Tetris
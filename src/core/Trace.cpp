@@ -0,0 +1,140 @@
+#include "core/Trace.hpp"
+
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Tetris::Trace {
+
+namespace {
+
+struct Event {
+    const char*  name;
+    const char*  category;
+    std::int64_t beginNs;
+    std::int64_t endNs;
+};
+
+struct ThreadBuffer {
+    std::vector<Event>         events;   // sized once, never grows
+    std::atomic<std::size_t>   count{0}; // published with release
+    std::atomic<std::uint64_t> dropped{0};
+    std::uint32_t              tid = 0;
+    std::string                name;     // guarded by g_registryMutex
+};
+
+std::mutex                                 g_registryMutex;
+std::vector<std::unique_ptr<ThreadBuffer>> g_buffers; // live until exit so
+                                                      // finished threads still flush
+std::filesystem::path g_outputPath;
+std::size_t           g_eventsPerThread = kDefaultEventsPerThread;
+std::int64_t          g_originNs        = 0;
+
+thread_local ThreadBuffer* t_buffer = nullptr;
+
+ThreadBuffer& threadBuffer() {
+    if (!t_buffer) {
+        auto buf = std::make_unique<ThreadBuffer>();
+        std::lock_guard lock(g_registryMutex);
+        buf->events.resize(g_eventsPerThread);
+        buf->tid = static_cast<std::uint32_t>(g_buffers.size());
+        t_buffer = buf.get();
+        g_buffers.push_back(std::move(buf));
+    }
+    return *t_buffer;
+}
+
+void writeEscaped(std::FILE* f, const char* s) {
+    for (; *s; ++s) {
+        if (*s == '"' || *s == '\\') std::fputc('\\', f);
+        std::fputc(*s, f);
+    }
+}
+
+} // namespace
+
+void detail::record(const char* name, const char* category, std::int64_t beginNs, std::int64_t endNs) {
+    ThreadBuffer& b = threadBuffer();
+    const std::size_t i = b.count.load(std::memory_order_relaxed);
+    if (i >= b.events.size()) {
+        b.dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    b.events[i] = Event{name, category, beginNs, endNs};
+    b.count.store(i + 1, std::memory_order_release);
+}
+
+void start(const std::filesystem::path& outputPath, std::size_t eventsPerThread) {
+    {
+        std::lock_guard lock(g_registryMutex);
+        g_outputPath      = outputPath;
+        g_eventsPerThread = eventsPerThread;
+        g_originNs        = detail::nowNs();
+    }
+    threadBuffer();
+    detail::g_enabled.store(true, std::memory_order_release);
+    std::fprintf(stderr, "[Trace] recording, output: %s\n", outputPath.string().c_str());
+}
+
+void setThreadName(const char* name) {
+    if (!enabled())
+        return;
+    ThreadBuffer& b = threadBuffer();
+    std::lock_guard lock(g_registryMutex);
+    b.name = name;
+}
+
+bool flush() {
+    if (!enabled())
+        return false;
+
+    std::lock_guard lock(g_registryMutex);
+
+    std::FILE* f = std::fopen(g_outputPath.string().c_str(), "wb");
+    if (!f) {
+        std::fprintf(stderr, "[Trace] cannot write %s\n", g_outputPath.string().c_str());
+        return false;
+    }
+
+    std::fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", f);
+    bool first = true;
+    std::size_t total = 0;
+    std::uint64_t dropped = 0;
+
+    for (const auto& b : g_buffers) {
+        if (!b->name.empty()) {
+            std::fprintf(f, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"",
+                         first ? "" : ",\n", b->tid);
+            writeEscaped(f, b->name.c_str());
+            std::fputs("\"}}", f);
+            first = false;
+        }
+
+        const std::size_t n = b->count.load(std::memory_order_acquire);
+        for (std::size_t i = 0; i < n; ++i) {
+            const Event& e = b->events[i];
+            std::fputs(first ? "{\"name\":\"" : ",\n{\"name\":\"", f);
+            writeEscaped(f, e.name);
+            std::fputs("\",\"cat\":\"", f);
+            writeEscaped(f, e.category);
+            std::fprintf(f, "\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                         b->tid,
+                         static_cast<double>(e.beginNs - g_originNs) / 1000.0,
+                         static_cast<double>(e.endNs - e.beginNs) / 1000.0);
+            first = false;
+        }
+        total   += n;
+        dropped += b->dropped.load(std::memory_order_relaxed);
+    }
+
+    std::fputs("\n]}\n", f);
+    const bool ok = std::fclose(f) == 0;
+
+    std::fprintf(stderr, "[Trace] wrote %zu events (%llu dropped) to %s\n",
+                 total, static_cast<unsigned long long>(dropped), g_outputPath.string().c_str());
+    return ok;
+}
+
+} // namespace Tetris::Trace
@@ -1,8 +1,20 @@
 #include <SFML/Graphics.hpp>
 #include "core/Application.hpp"
+#include "core/LaunchOptions.hpp"
+#include "core/Trace.hpp"
 
-int main() {
-    Tetris::Application app;
-    app.run();
+int main(int argc, char** argv) {
+    const auto options = Tetris::parseLaunchOptions(argc, argv);
+    if (!options.tracePath.empty()) {
+        Tetris::Trace::start(options.tracePath);
+        Tetris::Trace::setThreadName("main");
+    }
+
+    {
+        Tetris::Application app(options);
+        app.run();
+    }
+
+    Tetris::Trace::flush();
     return 0;
 }
@@ -0,0 +1,681 @@
+#include "game/Fumen.hpp"
+#include "game/Logic.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace Tetris {
+
+static constexpr int kUnchangedField = 8 * kFumenCells + kFumenCells - 1; // one run, no diff ("vh")
+static constexpr int kRepeatMax      = 63;   // one digit of unchanged pages
+static constexpr int kCommentMax     = 4095; // escaped characters, two digits
+static constexpr int kCommentRadix   = 96;   // ' '..'~' plus one unused value
+
+static constexpr char kBase64[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+static constexpr auto kDigit = [] {
+    std::array<std::int8_t, 256> t{};
+    t.fill(-1);
+    for (int i = 0; i < 64; ++i)
+        t[static_cast<unsigned char>(kBase64[i])] = static_cast<std::int8_t>(i);
+    return t;
+}();
+
+// fumen stores rotation as 0 reverse, 1 right, 2 spawn, 3 left; the same
+// table maps both ways
+static constexpr std::uint8_t kRawRotation[4] = {2, 1, 0, 3};
+
+using Cells = std::array<std::array<int, 2>, 4>;
+
+// spawn orientation around fumen's centre block, indexed by FumenPiece
+static constexpr std::array<Cells, 8> kFumenShapes = {{
+    {},
+    {{{0, 0}, {-1, 0}, {1, 0}, {2, 0}}},  // I
+    {{{0, 0}, {-1, 0}, {1, 0}, {1, 1}}},  // L
+    {{{0, 0}, {1, 0}, {0, 1}, {1, 1}}},   // O
+    {{{0, 0}, {1, 0}, {0, 1}, {-1, 1}}},  // Z
+    {{{0, 0}, {-1, 0}, {1, 0}, {0, 1}}},  // T
+    {{{0, 0}, {-1, 0}, {1, 0}, {-1, 1}}}, // J
+    {{{0, 0}, {-1, 0}, {0, 1}, {1, 1}}},  // S
+}};
+
+static bool isMino(FumenPiece p) { return p >= FumenPiece::I && p <= FumenPiece::S; }
+
+static Tetromino toTetromino(FumenPiece p) {
+    static constexpr Tetromino k[8] = {Tetromino::I, Tetromino::I, Tetromino::L, Tetromino::O,
+                                       Tetromino::Z, Tetromino::T, Tetromino::J, Tetromino::S};
+    return k[static_cast<int>(p) & 7];
+}
+
+static FumenPiece toFumen(Tetromino t) {
+    static constexpr FumenPiece k[7] = {FumenPiece::I, FumenPiece::J, FumenPiece::L, FumenPiece::O,
+                                        FumenPiece::S, FumenPiece::T, FumenPiece::Z};
+    return k[static_cast<int>(t)];
+}
+
+static Cell toCell(FumenPiece p) {
+    if (p == FumenPiece::Empty) return 0;
+    if (p == FumenPiece::Gray)  return 8; // no tetromino: drawn grey
+    return cellValue(toTetromino(p));
+}
+
+static FumenPiece fromCell(Cell v) {
+    if (v == 0) return FumenPiece::Empty;
+    if (v > 7)  return FumenPiece::Gray;
+    return toFumen(static_cast<Tetromino>(v - 1));
+}
+
+static Cells rotated(FumenPiece p, int rot) {
+    Cells c = kFumenShapes[static_cast<int>(p)];
+    for (auto& b : c) {
+        const int x = b[0], y = b[1];
+        switch (rot & 3) {
+            case 1:  b = {y, -x};  break; // right
+            case 2:  b = {-x, -y}; break; // reverse
+            case 3:  b = {-y, x};  break; // left
+            default: break;
+        }
+    }
+    return c;
+}
+
+// Fumen's stored location is off by one for some O / I / S / Z orientations
+// compared to the rotation centre the shapes above use.
+static void locationOffset(FumenPiece p, int rot, int& dx, int& dy) {
+    dx = dy = 0;
+    switch (p) {
+        case FumenPiece::O:
+            if (rot == 0)      dy = -1;
+            else if (rot == 2) dx = 1;
+            else if (rot == 3) { dx = 1; dy = -1; }
+            break;
+        case FumenPiece::I: if (rot == 2) dx = 1; break;
+        case FumenPiece::S:
+            if (rot == 0)      dy = -1;
+            else if (rot == 1) dx = -1;
+            break;
+        case FumenPiece::Z:
+            if (rot == 0)      dy = -1;
+            else if (rot == 3) dx = 1;
+            break;
+        default: break;
+    }
+}
+
+bool fumenPieceCells(const FumenPage& page, Cells& cells) {
+    if (!isMino(page.piece))
+        return false;
+    cells = rotated(page.piece, page.rotation);
+    for (auto& c : cells) {
+        c[0] += page.x;
+        c[1] += page.y;
+        if (c[0] < 0 || c[0] >= kFumenWidth || c[1] < 0 || c[1] >= kFumenHeight)
+            return false;
+    }
+    return true;
+}
+
+// What the next page's field is diffed against.
+static void applyLock(const FumenPage& page, std::array<FumenPiece, kFumenCells>& f) {
+    Cells cells;
+    if (fumenPieceCells(page, cells))
+        for (const auto& c : cells)
+            f[fumenIndex(c[0], c[1])] = page.piece;
+
+    // full rows of the playfield go, everything above drops (the garbage row stays)
+    int dst = kFumenHeight - 1;
+    for (int r = kFumenHeight - 1; r >= 0; --r) {
+        const auto row = f.begin() + r * kFumenWidth;
+        if (std::find(row, row + kFumenWidth, FumenPiece::Empty) == row + kFumenWidth)
+            continue;
+        if (dst != r)
+            std::copy_n(row, kFumenWidth, f.begin() + dst * kFumenWidth);
+        --dst;
+    }
+    for (; dst >= 0; --dst)
+        std::fill_n(f.begin() + dst * kFumenWidth, kFumenWidth, FumenPiece::Empty);
+
+    if (page.rise) {
+        std::copy(f.begin() + kFumenWidth, f.end(), f.begin());
+        std::fill(f.end() - kFumenWidth, f.end(), FumenPiece::Empty);
+    }
+    if (page.mirror)
+        for (int r = 0; r < kFumenHeight; ++r)
+            std::reverse(f.begin() + r * kFumenWidth, f.begin() + (r + 1) * kFumenWidth);
+}
+
+// ---- comment text: JS escape() / unescape() over UTF-8 ---------------------
+
+static void putUtf8(std::string& out, std::uint32_t cp) {
+    if (cp < 0x80) {
+        out += static_cast<char>(cp);
+    } else if (cp < 0x800) {
+        out += static_cast<char>(0xC0 | (cp >> 6));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        out += static_cast<char>(0xE0 | (cp >> 12));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (cp >> 18));
+        out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    }
+}
+
+// next code point; malformed bytes come out as U+FFFD
+static std::uint32_t getUtf8(std::string_view s, std::size_t& i) {
+    const auto b = static_cast<unsigned char>(s[i++]);
+    if (b < 0x80)
+        return b;
+    const int extra = b >= 0xF0 ? 3 : b >= 0xE0 ? 2 : b >= 0xC0 ? 1 : -1;
+    if (extra < 0 || i + static_cast<std::size_t>(extra) > s.size())
+        return 0xFFFD;
+    std::uint32_t cp = b & (0x3F >> extra);
+    for (int k = 0; k < extra; ++k) {
+        const auto c = static_cast<unsigned char>(s[i]);
+        if ((c & 0xC0) != 0x80)
+            return 0xFFFD;
+        cp = cp << 6 | (c & 0x3F);
+        ++i;
+    }
+    return cp;
+}
+
+static void escapeComment(std::string_view text, std::string& out) {
+    static constexpr char kHex[] = "0123456789ABCDEF";
+    out.clear();
+    const auto unit = [&](std::uint32_t u) {
+        if (u >= 0x100) {
+            out += "%u";
+            for (int shift = 12; shift >= 0; shift -= 4) out += kHex[(u >> shift) & 0xF];
+        } else if ((u >= '0' && u <= '9') || (u >= 'A' && u <= 'Z') || (u >= 'a' && u <= 'z')
+                   || (u != 0 && std::strchr("@*_+-./", static_cast<int>(u)))) {
+            out += static_cast<char>(u);
+        } else {
+            out += '%';
+            out += kHex[u >> 4];
+            out += kHex[u & 0xF];
+        }
+    };
+    for (std::size_t i = 0; i < text.size();) {
+        const std::uint32_t cp = getUtf8(text, i);
+        if (cp >= 0x10000) { // UTF-16 surrogate pair, as JavaScript strings are
+            unit(0xD800 + ((cp - 0x10000) >> 10));
+            unit(0xDC00 + ((cp - 0x10000) & 0x3FF));
+        } else {
+            unit(cp);
+        }
+    }
+}
+
+static int hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+static void unescapeComment(std::string_view in, std::string& out) {
+    out.clear();
+    std::uint32_t high = 0; // pending high surrogate
+    const auto hex = [&](std::size_t at, int digits) -> int {
+        if (at + static_cast<std::size_t>(digits) > in.size()) return -1;
+        int v = 0;
+        for (int k = 0; k < digits; ++k) {
+            const int h = hexValue(in[at + static_cast<std::size_t>(k)]);
+            if (h < 0) return -1;
+            v = v << 4 | h;
+        }
+        return v;
+    };
+    for (std::size_t i = 0; i < in.size();) {
+        std::uint32_t u = static_cast<unsigned char>(in[i]);
+        int v;
+        if (in[i] == '%' && i + 1 < in.size() && in[i + 1] == 'u' && (v = hex(i + 2, 4)) >= 0) {
+            u = static_cast<std::uint32_t>(v);
+            i += 6;
+        } else if (in[i] == '%' && (v = hex(i + 1, 2)) >= 0) {
+            u = static_cast<std::uint32_t>(v);
+            i += 3;
+        } else {
+            ++i;
+        }
+        if (high && u >= 0xDC00 && u < 0xE000) {
+            putUtf8(out, 0x10000 + ((high - 0xD800) << 10) + (u - 0xDC00));
+            high = 0;
+            continue;
+        }
+        if (high)
+            putUtf8(out, 0xFFFD);
+        high = 0;
+        if (u >= 0xD800 && u < 0xDC00)
+            high = u;
+        else
+            putUtf8(out, u >= 0xDC00 && u < 0xE000 ? 0xFFFD : u);
+    }
+    if (high)
+        putUtf8(out, 0xFFFD);
+}
+
+// ---- quiz comments ---------------------------------------------------------
+
+static FumenPiece pieceFromLetter(char c) {
+    switch (c) {
+        case 'I': return FumenPiece::I; case 'L': return FumenPiece::L; case 'O': return FumenPiece::O;
+        case 'Z': return FumenPiece::Z; case 'T': return FumenPiece::T; case 'J': return FumenPiece::J;
+        case 'S': return FumenPiece::S; default:  return FumenPiece::Empty;
+    }
+}
+
+static char pieceLetter(FumenPiece p) { return "_ILOZTJSX"[static_cast<int>(p) % 9]; }
+
+bool parseFumenQuiz(std::string_view c, FumenQuiz& q) {
+    if (!c.starts_with("#Q=["))
+        return false;
+    q = {};
+    std::size_t i = 4;
+    if (i < c.size() && c[i] != ']') {
+        if ((q.hold = pieceFromLetter(c[i++])) == FumenPiece::Empty)
+            return false;
+    }
+    if (c.substr(i, 2) != "](")
+        return false;
+    i += 2;
+    if (i < c.size() && c[i] != ')') {
+        if ((q.current = pieceFromLetter(c[i++])) == FumenPiece::Empty)
+            return false;
+    }
+    if (i >= c.size() || c[i++] != ')')
+        return false;
+    for (FumenPiece p; i < c.size() && q.count < kFumenQuizMax
+                       && (p = pieceFromLetter(c[i])) != FumenPiece::Empty; ++i)
+        q.next[static_cast<std::size_t>(q.count++)] = p;
+    return true;
+}
+
+void formatFumenQuiz(const FumenQuiz& q, std::string& out) {
+    out.assign("#Q=[");
+    if (q.hold != FumenPiece::Empty) out += pieceLetter(q.hold);
+    out += "](";
+    if (q.current != FumenPiece::Empty) out += pieceLetter(q.current);
+    out += ')';
+    for (int i = 0; i < q.count; ++i)
+        out += pieceLetter(q.next[static_cast<std::size_t>(i)]);
+}
+
+bool advanceFumenQuiz(FumenQuiz& q, FumenPiece used) {
+    const FumenQuiz before = q;
+    const auto popNext = [&q] {
+        if (q.count == 0)
+            return FumenPiece::Empty;
+        const FumenPiece p = q.next[0];
+        std::copy(q.next.begin() + 1, q.next.begin() + q.count, q.next.begin());
+        --q.count;
+        return p;
+    };
+    if (q.current == FumenPiece::Empty)
+        q.current = popNext();
+
+    if (used == q.current) {
+        q.current = popNext();
+    } else if (q.hold != FumenPiece::Empty && used == q.hold) {
+        q.hold    = q.current;
+        q.current = popNext();
+    } else if (q.hold == FumenPiece::Empty && q.count > 0 && used == q.next[0]) {
+        q.hold = q.current;
+        popNext();
+        q.current = popNext();
+    } else {
+        q = before;
+        return false;
+    }
+    return true;
+}
+
+// ---- codec -----------------------------------------------------------------
+
+namespace {
+
+// Little-endian base64 digits; '?' (fumen's line breaks) is skipped.
+struct DigitReader {
+    std::string_view s;
+    std::size_t      pos = 0;
+    bool             bad = false;
+
+    void skip() { while (pos < s.size() && s[pos] == '?') ++pos; }
+    bool atEnd() { skip(); return pos >= s.size(); }
+
+    int poll(int n) {
+        int v = 0;
+        for (int k = 0, mul = 1; k < n; ++k, mul *= 64) {
+            skip();
+            const int d = pos < s.size() ? kDigit[static_cast<unsigned char>(s[pos++])] : -1;
+            if (d < 0) {
+                bad = true;
+                return 0;
+            }
+            v += d * mul;
+        }
+        return v;
+    }
+};
+
+void putDigits(std::string& out, int v, int n) {
+    for (int k = 0; k < n; ++k, v /= 64)
+        out += kBase64[v % 64];
+}
+
+} // namespace
+
+bool decodeFumen(std::string_view text, std::vector<FumenPage>& pages) {
+    const std::size_t at = text.find("115@");
+    if (at == std::string_view::npos || at == 0
+        || (text[at - 1] != 'v' && text[at - 1] != 'm' && text[at - 1] != 'd')) {
+        pages.clear();
+        return false;
+    }
+    text.remove_prefix(at + 4);
+    while (!text.empty() && (text.back() == '\n' || text.back() == '\r' || text.back() == ' ' || text.back() == '\t'))
+        text.remove_suffix(1);
+
+    DigitReader in{text};
+    std::array<FumenPiece, kFumenCells> prev{}; // previous page after its lock
+    std::string escaped;
+    FumenQuiz   quiz;
+    bool        quizActive = false;
+    int         repeat     = 0;
+    std::size_t count      = 0;
+
+    const auto fail = [&] {
+        pages.clear();
+        return false;
+    };
+
+    while (!in.atEnd()) {
+        if (count == pages.size())
+            pages.emplace_back();
+        FumenPage& p = pages[count];
+
+        if (repeat > 0) {
+            p.field = prev;
+            --repeat;
+        } else {
+            for (int i = 0; i < kFumenCells;) {
+                const int v    = in.poll(2);
+                const int diff = v / kFumenCells - 8;
+                const int len  = v % kFumenCells + 1;
+                if (in.bad || diff > 8 || i + len > kFumenCells)
+                    return fail();
+                if (v == kUnchangedField)
+                    repeat = in.poll(1);
+                if (diff == 0) { // the common case: cells carried over
+                    std::copy_n(prev.begin() + i, len, p.field.begin() + i);
+                    i += len;
+                    continue;
+                }
+                for (const int end = i + len; i < end; ++i) {
+                    const int c = static_cast<int>(prev[static_cast<std::size_t>(i)]) + diff;
+                    if (c < 0 || c > static_cast<int>(FumenPiece::Gray))
+                        return fail();
+                    p.field[static_cast<std::size_t>(i)] = static_cast<FumenPiece>(c);
+                }
+            }
+        }
+
+        int v = in.poll(3);
+        const int type = v % 8;  v /= 8;
+        const int raw  = v % 4;  v /= 4;
+        const int loc  = v % kFumenCells; v /= kFumenCells;
+        p.rise     = v & 1;
+        p.mirror   = v >> 1 & 1;
+        p.colorize = v >> 2 & 1;
+        const bool comment = v >> 3 & 1;
+        p.lock     = !(v >> 4 & 1);
+        if (in.bad || v >= 32)
+            return fail();
+
+        p.piece    = static_cast<FumenPiece>(type);
+        p.rotation = 0;
+        p.x = p.y  = 0;
+        if (isMino(p.piece)) {
+            int dx, dy;
+            p.rotation = kRawRotation[raw];
+            locationOffset(p.piece, p.rotation, dx, dy);
+            p.x = static_cast<std::int8_t>(loc % kFumenWidth + dx);
+            p.y = static_cast<std::int8_t>(kFumenHeight - 1 - loc / kFumenWidth + dy);
+        }
+
+        if (comment) {
+            const int len = in.poll(2);
+            escaped.clear();
+            for (int i = 0; i < len; i += 4) {
+                int chunk = in.poll(5);
+                for (int k = 0; k < 4 && i + k < len; ++k, chunk /= kCommentRadix) {
+                    const int c = chunk % kCommentRadix;
+                    if (c >= kCommentRadix - 1)
+                        return fail();
+                    escaped += static_cast<char>(' ' + c);
+                }
+            }
+            if (in.bad)
+                return fail();
+            unescapeComment(escaped, p.comment);
+            quizActive = parseFumenQuiz(p.comment, quiz);
+        } else if (count == 0) {
+            p.comment.clear();
+        } else if (quizActive) {
+            formatFumenQuiz(quiz, p.comment);
+        } else {
+            p.comment = pages[count - 1].comment;
+        }
+
+        if (p.lock) {
+            if (quizActive && isMino(p.piece))
+                advanceFumenQuiz(quiz, p.piece);
+            prev = p.field;
+            applyLock(p, prev);
+        } else {
+            prev = p.field;
+        }
+        ++count;
+    }
+    if (count == 0 || repeat > 0)
+        return fail();
+    pages.resize(count);
+    return true;
+}
+
+void encodeFumen(std::span<const FumenPage> pages, std::string& out) {
+    out += "v115@";
+    std::array<FumenPiece, kFumenCells> prev{};
+    std::size_t repeatAt   = std::string::npos; // digit counting unchanged pages
+    FumenQuiz   quiz;
+    bool        quizActive = false;
+    std::string expected, escaped;
+
+    for (std::size_t n = 0; n < pages.size(); ++n) {
+        const FumenPage& p = pages[n];
+
+        if (p.field != prev) {
+            int runDiff = static_cast<int>(p.field[0]) - static_cast<int>(prev[0]) + 8;
+            int runLen  = 0;
+            for (std::size_t i = 0; i < p.field.size(); ++i) {
+                const int diff = static_cast<int>(p.field[i]) - static_cast<int>(prev[i]) + 8;
+                if (diff != runDiff) {
+                    putDigits(out, runDiff * kFumenCells + runLen - 1, 2);
+                    runDiff = diff;
+                    runLen  = 0;
+                }
+                ++runLen;
+            }
+            putDigits(out, runDiff * kFumenCells + runLen - 1, 2);
+            repeatAt = std::string::npos;
+        } else if (repeatAt != std::string::npos && kDigit[static_cast<unsigned char>(out[repeatAt])] < kRepeatMax) {
+            out[repeatAt] = kBase64[kDigit[static_cast<unsigned char>(out[repeatAt])] + 1];
+        } else {
+            putDigits(out, kUnchangedField, 2);
+            repeatAt = out.size();
+            out += kBase64[0];
+        }
+
+        // what the decoder would carry over; only a different comment is written
+        if (n == 0)
+            expected.clear();
+        else if (quizActive)
+            formatFumenQuiz(quiz, expected);
+        else
+            expected = pages[n - 1].comment;
+        const bool comment = p.comment != expected;
+        if (comment)
+            quizActive = parseFumenQuiz(p.comment, quiz);
+
+        int raw = 0, loc = 0;
+        FumenPiece piece = p.piece;
+        if (isMino(piece)) {
+            int dx, dy;
+            locationOffset(piece, p.rotation & 3, dx, dy);
+            const int x = p.x - dx, y = p.y - dy;
+            raw = kRawRotation[p.rotation & 3];
+            loc = (kFumenHeight - 1 - y) * kFumenWidth + x;
+            if (x < 0 || x >= kFumenWidth || loc < 0 || loc >= kFumenCells) // unrepresentable: no piece
+                piece = FumenPiece::Empty, raw = loc = 0;
+        } else if (piece != FumenPiece::Empty) {
+            piece = FumenPiece::Empty; // Gray is a cell, not a piece
+        }
+        int v = p.lock ? 0 : 1;
+        v = v * 2 + comment;
+        v = v * 2 + p.colorize;
+        v = v * 2 + p.mirror;
+        v = v * 2 + p.rise;
+        v = ((v * kFumenCells + loc) * 4 + raw) * 8 + static_cast<int>(piece);
+        putDigits(out, v, 3);
+
+        if (comment) {
+            escapeComment(p.comment, escaped);
+            const int len = std::min(static_cast<int>(escaped.size()), kCommentMax);
+            putDigits(out, len, 2);
+            for (int i = 0; i < len; i += 4) {
+                int chunk = 0;
+                for (int k = 3; k >= 0; --k)
+                    chunk = chunk * kCommentRadix + (i + k < len ? escaped[static_cast<std::size_t>(i + k)] - ' ' : 0);
+                putDigits(out, chunk, 5);
+            }
+        }
+
+        prev = p.field;
+        if (p.lock) {
+            if (quizActive && isMino(piece))
+                advanceFumenQuiz(quiz, piece);
+            if (piece == p.piece) {
+                applyLock(p, prev);
+            } else { // dropped above: lock without it, as the decoder will
+                FumenPage bare = p;
+                bare.piece = FumenPiece::Empty;
+                applyLock(bare, prev);
+            }
+        }
+    }
+}
+
+// ---- GameState -------------------------------------------------------------
+
+bool fumenToState(const FumenPage& page, GameState& s) {
+    bool fits = true;
+    for (int y = 0; y < kFumenHeight; ++y) {
+        for (int x = 0; x < kFumenWidth; ++x) {
+            const FumenPiece f = page.field[static_cast<std::size_t>(fumenIndex(x, y))];
+            if (y < ROWS)
+                s.grid[static_cast<std::size_t>(y * COLS + x)] = toCell(f);
+            else if (f != FumenPiece::Empty)
+                fits = false;
+        }
+    }
+
+    // hold, the piece in play and what follows it
+    FumenPiece hold = FumenPiece::Empty, current = FumenPiece::Empty;
+    std::array<Tetromino, kFumenQuizMax + 1> queue{};
+    std::size_t queued = 0;
+    if (FumenQuiz q; parseFumenQuiz(page.comment, q)) {
+        if (isMino(page.piece)) {
+            advanceFumenQuiz(q, page.piece); // if it isn't from the quiz the quiz just stays queued
+            current = page.piece;
+            if (q.current != FumenPiece::Empty)
+                queue[queued++] = toTetromino(q.current);
+        } else {
+            current = q.current;
+            if (current == FumenPiece::Empty && q.count > 0) {
+                current = q.next[0];
+                std::copy(q.next.begin() + 1, q.next.begin() + q.count, q.next.begin());
+                --q.count;
+            }
+        }
+        hold = q.hold;
+        for (int i = 0; i < q.count; ++i)
+            queue[queued++] = toTetromino(q.next[static_cast<std::size_t>(i)]);
+    } else if (isMino(page.piece)) {
+        current = page.piece;
+    }
+
+    s.hasHold  = hold != FumenPiece::Empty;
+    s.holdType = s.hasHold ? toTetromino(hold) : Tetromino{};
+    s.canHold  = true;
+    s.bag.preload({queue.data(), queued});
+    if (current == FumenPiece::Empty)
+        return fits && !blocked(s, s.active);
+
+    spawnActive(s, toTetromino(current));
+    Cells cells;
+    if (current == page.piece && fumenPieceCells(page, cells)) {
+        // same blocks, our rotation centre: align the bounding boxes
+        const auto& ours = shape(s.active.type).cells[page.rotation & 3];
+        int fx = kFumenWidth, fy = kFumenHeight, ox = 4, oy = 4;
+        for (int i = 0; i < 4; ++i) {
+            fx = std::min(fx, cells[static_cast<std::size_t>(i)][0]);
+            fy = std::min(fy, cells[static_cast<std::size_t>(i)][1]);
+            ox = std::min(ox, static_cast<int>(ours[static_cast<std::size_t>(i)][0]));
+            oy = std::min(oy, static_cast<int>(ours[static_cast<std::size_t>(i)][1]));
+        }
+        ActivePiece placed = s.active;
+        placed.rot = page.rotation & 3;
+        placed.x   = fx - ox;
+        placed.y   = fy - oy;
+        if (!blocked(s, placed)) {
+            s.active = placed;
+            return fits;
+        }
+    }
+    return fits && !blocked(s, s.active);
+}
+
+void stateToFumen(const GameState& s, FumenPage& page) {
+    page = FumenPage{};
+    for (int y = 0; y < ROWS; ++y)
+        for (int x = 0; x < COLS; ++x)
+            page.field[static_cast<std::size_t>(fumenIndex(x, y))] = fromCell(s.grid[static_cast<std::size_t>(y * COLS + x)]);
+    page.lock = false; // a piece in the air, not a placement
+
+    FumenQuiz q;
+    if (!s.gameOver) {
+        page.piece    = toFumen(s.active.type);
+        page.rotation = static_cast<std::uint8_t>(s.active.rot & 3);
+        const auto& ours  = shape(s.active.type).cells[page.rotation];
+        const Cells theirs = rotated(page.piece, page.rotation);
+        int ox = 4, oy = 4, fx = 4, fy = 4;
+        for (std::size_t i = 0; i < 4; ++i) {
+            ox = std::min(ox, static_cast<int>(ours[i][0]));
+            oy = std::min(oy, static_cast<int>(ours[i][1]));
+            fx = std::min(fx, theirs[i][0]);
+            fy = std::min(fy, theirs[i][1]);
+        }
+        page.x    = static_cast<std::int8_t>(s.active.x + ox - fx);
+        page.y    = static_cast<std::int8_t>(s.active.y + oy - fy);
+        q.current = page.piece;
+    }
+    q.hold = s.hasHold ? toFumen(s.holdType) : FumenPiece::Empty;
+    for (; q.count < kFumenQuizPreview; ++q.count)
+        q.next[static_cast<std::size_t>(q.count)] = toFumen(s.bag.peek(static_cast<std::size_t>(q.count)));
+    formatFumenQuiz(q, page.comment);
+}
+
+} // namespace Tetris
@@ -0,0 +1,524 @@
+#include "game/Replay.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <limits>
+
+namespace Tetris {
+
+static constexpr std::uint8_t kCodeReleaseBase = 8;
+static constexpr std::uint8_t kCodeKeyframe    = 14;
+static constexpr std::uint8_t kCodeEnd         = 15;
+
+// ---- little-endian helpers ----------------------------------------------
+
+static void putU16(std::vector<std::uint8_t>& b, std::uint16_t v) {
+    b.push_back(static_cast<std::uint8_t>(v));
+    b.push_back(static_cast<std::uint8_t>(v >> 8));
+}
+static void putU32(std::vector<std::uint8_t>& b, std::uint32_t v) {
+    for (int i = 0; i < 4; ++i) b.push_back(static_cast<std::uint8_t>(v >> (8 * i)));
+}
+static void putU64(std::vector<std::uint8_t>& b, std::uint64_t v) {
+    for (int i = 0; i < 8; ++i) b.push_back(static_cast<std::uint8_t>(v >> (8 * i)));
+}
+static void putVarint(std::vector<std::uint8_t>& b, std::uint64_t v) {
+    while (v >= 0x80) {
+        b.push_back(static_cast<std::uint8_t>(v | 0x80));
+        v >>= 7;
+    }
+    b.push_back(static_cast<std::uint8_t>(v));
+}
+
+static void putZigzag(std::vector<std::uint8_t>& b, std::int64_t v) {
+    putVarint(b, (static_cast<std::uint64_t>(v) << 1) ^ static_cast<std::uint64_t>(v >> 63));
+}
+
+static std::uint64_t getLE(const std::uint8_t* p, int n) {
+    std::uint64_t v = 0;
+    for (int i = 0; i < n; ++i) v |= std::uint64_t{p[i]} << (8 * i);
+    return v;
+}
+
+// bounds-checked reader; any overrun just clears `ok`
+struct ByteReader {
+    std::span<const std::uint8_t> bytes;
+    std::size_t pos = 0;
+    bool        ok  = true;
+
+    std::uint8_t u8() {
+        if (pos >= bytes.size()) { ok = false; return 0; }
+        return bytes[pos++];
+    }
+    std::uint64_t u64() {
+        if (bytes.size() - pos < 8) { ok = false; return 0; }
+        pos += 8;
+        return getLE(bytes.data() + pos - 8, 8);
+    }
+    std::uint64_t varint() {
+        std::uint64_t v = 0;
+        for (unsigned shift = 0; shift < 64; shift += 7) {
+            const std::uint8_t b = u8();
+            v |= std::uint64_t{b & 0x7Fu} << shift;
+            if (!(b & 0x80)) return v;
+        }
+        ok = false;
+        return 0;
+    }
+    std::int64_t zigzag() {
+        const std::uint64_t v = varint();
+        return static_cast<std::int64_t>(v >> 1) ^ -static_cast<std::int64_t>(v & 1);
+    }
+};
+
+// ---- keyframes ------------------------------------------------------------
+
+enum : std::uint16_t {
+    kFlagGrounded      = 1 << 0,
+    kFlagHasHold       = 1 << 1,
+    kFlagCanHold       = 1 << 2,
+    kFlagGameOver      = 1 << 3,
+    kFlagSprintDone    = 1 << 4,
+    kFlagSprintTimer   = 1 << 5,
+    kFlagSoftDropHeld  = 1 << 6,
+    kFlagLeftHeld      = 1 << 7,
+    kFlagRightHeld     = 1 << 8,
+};
+
+void packCheckpoint(const Simulation::Checkpoint& cp, std::vector<std::uint8_t>& out) {
+    const GameState& s = cp.state;
+    putVarint(out, static_cast<std::uint64_t>(cp.timeUs));
+
+    // cells are 0 (empty) or piece + 1: two per byte
+    static_assert((COLS * ROWS) % 2 == 0);
+    for (std::size_t i = 0; i < s.grid.size(); i += 2)
+        out.push_back(static_cast<std::uint8_t>((s.grid[i] & 0xF) | (s.grid[i + 1] << 4)));
+
+    const SevenBag::Saved bag = s.bag.save();
+    putU64(out, bag.rng);
+    for (Tetromino t : bag.bag)     out.push_back(static_cast<std::uint8_t>(t));
+    for (Tetromino t : bag.nextBag) out.push_back(static_cast<std::uint8_t>(t));
+    out.push_back(bag.pos);
+
+    out.push_back(static_cast<std::uint8_t>(s.active.type));
+    putZigzag(out, s.active.x);
+    putZigzag(out, s.active.y);
+    out.push_back(static_cast<std::uint8_t>(s.active.rot));
+
+    putVarint(out, static_cast<std::uint64_t>(s.rowIntervalUs));
+    putVarint(out, static_cast<std::uint64_t>(s.fallAccUs));
+    putVarint(out, static_cast<std::uint64_t>(s.level));
+    putVarint(out, static_cast<std::uint64_t>(s.lockDelayUs));
+    putVarint(out, static_cast<std::uint64_t>(s.lockTimerUs));
+    putVarint(out, static_cast<std::uint64_t>(s.lockResets));
+    putVarint(out, static_cast<std::uint64_t>(s.maxLockResets));
+    out.push_back(static_cast<std::uint8_t>(s.holdType));
+    out.push_back(static_cast<std::uint8_t>(s.runType));
+    putVarint(out, static_cast<std::uint64_t>(s.totalLinesCleared));
+    putVarint(out, static_cast<std::uint64_t>(s.piecesPlaced));
+    putVarint(out, static_cast<std::uint64_t>(s.sprintTargetLines));
+    putVarint(out, static_cast<std::uint64_t>(s.sprintTimeUs));
+
+    std::uint16_t flags = 0;
+    if (s.grounded)           flags |= kFlagGrounded;
+    if (s.hasHold)            flags |= kFlagHasHold;
+    if (s.canHold)            flags |= kFlagCanHold;
+    if (s.gameOver)           flags |= kFlagGameOver;
+    if (s.sprintCompleted)    flags |= kFlagSprintDone;
+    if (s.sprintTimerRunning) flags |= kFlagSprintTimer;
+    if (cp.softDropHeld)      flags |= kFlagSoftDropHeld;
+    if (cp.left.held)         flags |= kFlagLeftHeld;
+    if (cp.right.held)        flags |= kFlagRightHeld;
+    putU16(out, flags);
+
+    putZigzag(out, cp.left.pressUs);
+    putVarint(out, static_cast<std::uint64_t>(cp.left.shifts));
+    putZigzag(out, cp.right.pressUs);
+    putVarint(out, static_cast<std::uint64_t>(cp.right.shifts));
+}
+
+bool unpackCheckpoint(std::span<const std::uint8_t> bytes, Simulation::Checkpoint& cp) {
+    ByteReader r{bytes};
+    GameState& s = cp.state;
+    const auto piece = [&r] {
+        const std::uint8_t v = r.u8();
+        if (v > static_cast<std::uint8_t>(Tetromino::Z)) r.ok = false;
+        return static_cast<Tetromino>(v);
+    };
+
+    cp.timeUs = static_cast<std::int64_t>(r.varint());
+
+    for (std::size_t i = 0; i < s.grid.size(); i += 2) {
+        const std::uint8_t b = r.u8();
+        s.grid[i]     = b & 0xF;
+        s.grid[i + 1] = b >> 4;
+    }
+
+    SevenBag::Saved bag;
+    bag.rng = r.u64();
+    for (Tetromino& t : bag.bag)     t = piece();
+    for (Tetromino& t : bag.nextBag) t = piece();
+    bag.pos = r.u8();
+    if (bag.pos > bag.bag.size()) r.ok = false;
+    s.bag.restore(bag);
+
+    s.active.type = piece();
+    s.active.x    = static_cast<int>(r.zigzag());
+    s.active.y    = static_cast<int>(r.zigzag());
+    s.active.rot  = r.u8() & 3;
+
+    s.rowIntervalUs     = static_cast<std::int64_t>(r.varint());
+    s.fallAccUs         = static_cast<std::int64_t>(r.varint());
+    s.level             = static_cast<int>(r.varint());
+    s.lockDelayUs       = static_cast<std::int64_t>(r.varint());
+    s.lockTimerUs       = static_cast<std::int64_t>(r.varint());
+    s.lockResets        = static_cast<int>(r.varint());
+    s.maxLockResets     = static_cast<int>(r.varint());
+    s.holdType          = piece();
+    const std::uint8_t run = r.u8();
+    if (run > static_cast<std::uint8_t>(RunType::Blitz)) r.ok = false;
+    s.runType           = static_cast<RunType>(run);
+    s.totalLinesCleared = static_cast<int>(r.varint());
+    s.piecesPlaced      = static_cast<int>(r.varint());
+    s.sprintTargetLines = static_cast<int>(r.varint());
+    s.sprintTimeUs      = static_cast<std::int64_t>(r.varint());
+
+    const std::uint16_t flags = static_cast<std::uint16_t>(r.u8() | (r.u8() << 8));
+    s.grounded           = flags & kFlagGrounded;
+    s.hasHold            = flags & kFlagHasHold;
+    s.canHold            = flags & kFlagCanHold;
+    s.gameOver           = flags & kFlagGameOver;
+    s.sprintCompleted    = flags & kFlagSprintDone;
+    s.sprintTimerRunning = flags & kFlagSprintTimer;
+    cp.softDropHeld      = flags & kFlagSoftDropHeld;
+    cp.left.held         = flags & kFlagLeftHeld;
+    cp.right.held        = flags & kFlagRightHeld;
+
+    cp.left.pressUs  = r.zigzag();
+    cp.left.shifts   = static_cast<std::int64_t>(r.varint());
+    cp.right.pressUs = r.zigzag();
+    cp.right.shifts  = static_cast<std::int64_t>(r.varint());
+
+    return r.ok && r.pos == bytes.size();
+}
+
+// ---- recorder -------------------------------------------------------------
+
+void ReplayRecorder::begin(const ReplayHeader& h) {
+    m_buf.clear();
+    m_buf.reserve(4096);
+    for (char c : kReplayMagic) m_buf.push_back(static_cast<std::uint8_t>(c));
+    putU16(m_buf, kReplayVersion);
+    m_buf.push_back(static_cast<std::uint8_t>(h.runType));
+    m_buf.push_back(0);
+    putU32(m_buf, std::bit_cast<std::uint32_t>(h.settings.das));
+    putU32(m_buf, std::bit_cast<std::uint32_t>(h.settings.arr));
+    putU32(m_buf, std::bit_cast<std::uint32_t>(h.settings.sdf));
+    putU64(m_buf, h.seed);
+    putU64(m_buf, static_cast<std::uint64_t>(h.startedUnix));
+
+    m_index.clear();
+    m_flushed      = 0;
+    m_lastUs       = 0;
+    m_nextKeyframe = kKeyframePieces;
+    m_active       = true;
+}
+
+void ReplayRecorder::record(const InputEvent& in) {
+    if (!m_active)
+        return;
+
+    std::uint8_t code;
+    if (in.pressed) {
+        code = static_cast<std::uint8_t>(in.action);
+    } else {
+        switch (in.action) {
+            case InputAction::Left:     code = kCodeReleaseBase + 0; break;
+            case InputAction::Right:    code = kCodeReleaseBase + 1; break;
+            case InputAction::SoftDrop: code = kCodeReleaseBase + 2; break;
+            default: return; // releasing a rotate / drop / hold key does nothing
+        }
+    }
+
+    const std::uint64_t delta = static_cast<std::uint64_t>(in.timeUs - m_lastUs);
+    m_lastUs = in.timeUs;
+    putVarint(m_buf, (delta << 4) | code);
+}
+
+void ReplayRecorder::keyframeIfDue(const Simulation& sim) {
+    const int pieces = sim.state().piecesPlaced;
+    if (!m_active || pieces < m_nextKeyframe)
+        return;
+    while (m_nextKeyframe <= pieces)
+        m_nextKeyframe += kKeyframePieces;
+
+    m_packed.clear();
+    packCheckpoint(sim.checkpoint(), m_packed);
+
+    putVarint(m_buf, (static_cast<std::uint64_t>(sim.timeUs() - m_lastUs) << 4) | kCodeKeyframe);
+    m_lastUs = sim.timeUs();
+    putVarint(m_buf, m_packed.size());
+
+    ReplayKeyframe kf;
+    kf.pieces = static_cast<std::uint32_t>(pieces);
+    kf.size   = static_cast<std::uint32_t>(m_packed.size());
+    kf.timeUs = sim.timeUs();
+    kf.offset = offset();
+    m_buf.insert(m_buf.end(), m_packed.begin(), m_packed.end());
+    kf.resume = offset();
+    m_index.push_back(kf);
+}
+
+void ReplayRecorder::end(const ReplayResult& r) {
+    if (!m_active)
+        return;
+    putVarint(m_buf, (static_cast<std::uint64_t>(r.endTimeUs - m_lastUs) << 4) | kCodeEnd);
+    putVarint(m_buf, r.lines);
+    putVarint(m_buf, r.pieces);
+    putVarint(m_buf, static_cast<std::uint64_t>(r.sprintTimeUs));
+    m_buf.push_back(r.gameOver ? 1 : 0);
+
+    const std::uint64_t indexOffset = offset();
+    for (const ReplayKeyframe& kf : m_index) {
+        putU32(m_buf, kf.pieces);
+        putU32(m_buf, kf.size);
+        putU64(m_buf, static_cast<std::uint64_t>(kf.timeUs));
+        putU64(m_buf, kf.offset);
+        putU64(m_buf, kf.resume);
+    }
+    putU64(m_buf, indexOffset);
+    putU32(m_buf, static_cast<std::uint32_t>(m_index.size()));
+    putU32(m_buf, kReplayIndexEntrySize);
+    for (char c : kReplayIndexMagic) m_buf.push_back(static_cast<std::uint8_t>(c));
+
+    m_active = false;
+}
+
+std::vector<std::uint8_t> ReplayRecorder::takeChunk() {
+    std::vector<std::uint8_t> out;
+    out.swap(m_buf);
+    m_buf.reserve(4096);
+    m_flushed += out.size();
+    return out;
+}
+
+// ---- decoder --------------------------------------------------------------
+
+bool ReplayDecoder::open(std::span<const std::uint8_t> bytes) {
+    *this = ReplayDecoder{};
+    if (bytes.size() < kReplayHeaderSize || std::memcmp(bytes.data(), kReplayMagic, sizeof(kReplayMagic)) != 0)
+        return false;
+
+    const std::uint8_t* p = bytes.data();
+    m_version = static_cast<std::uint16_t>(getLE(p + 8, 2));
+    if (m_version < 1 || m_version > kReplayVersion || p[10] > static_cast<std::uint8_t>(RunType::Blitz))
+        return false;
+
+    m_header.runType      = static_cast<RunType>(p[10]);
+    m_header.settings.das = std::bit_cast<float>(static_cast<std::uint32_t>(getLE(p + 12, 4)));
+    m_header.settings.arr = std::bit_cast<float>(static_cast<std::uint32_t>(getLE(p + 16, 4)));
+    m_header.settings.sdf = std::bit_cast<float>(static_cast<std::uint32_t>(getLE(p + 20, 4)));
+    m_header.seed         = getLE(p + 24, 8);
+    m_header.startedUnix  = static_cast<std::int64_t>(getLE(p + 32, 8));
+
+    m_bytes = bytes;
+    m_pos   = kReplayHeaderSize;
+    m_end   = bytes.size();
+    if (m_version >= 2)
+        readIndex();
+    return true;
+}
+
+void ReplayDecoder::readIndex() {
+    // a run that never finished (crash) has no footer: it still plays,
+    // seeking just starts from the beginning
+    if (m_bytes.size() < kReplayHeaderSize + kReplayTrailerSize)
+        return;
+    const std::uint8_t* t = m_bytes.data() + m_bytes.size() - kReplayTrailerSize;
+    if (std::memcmp(t + 16, kReplayIndexMagic, sizeof(kReplayIndexMagic)) != 0)
+        return;
+
+    const std::uint64_t indexOffset = getLE(t, 8);
+    const std::uint64_t count       = getLE(t + 8, 4);
+    const std::uint64_t entrySize   = getLE(t + 12, 4);
+    const std::uint64_t indexEnd    = m_bytes.size() - kReplayTrailerSize;
+    if (entrySize < kReplayIndexEntrySize || indexOffset < kReplayHeaderSize || indexOffset > indexEnd
+        || count > (indexEnd - indexOffset) / entrySize)
+        return;
+
+    m_end = static_cast<std::size_t>(indexOffset);
+    m_keyframes.reserve(static_cast<std::size_t>(count));
+    for (std::uint64_t i = 0; i < count; ++i) {
+        const std::uint8_t* e = m_bytes.data() + indexOffset + i * entrySize;
+        ReplayKeyframe kf;
+        kf.pieces = static_cast<std::uint32_t>(getLE(e, 4));
+        kf.size   = static_cast<std::uint32_t>(getLE(e + 4, 4));
+        kf.timeUs = static_cast<std::int64_t>(getLE(e + 8, 8));
+        kf.offset = getLE(e + 16, 8);
+        kf.resume = getLE(e + 24, 8);
+
+        const bool ordered = m_keyframes.empty()
+                          || (kf.timeUs >= m_keyframes.back().timeUs && kf.pieces >= m_keyframes.back().pieces);
+        if (!ordered || kf.offset < kReplayHeaderSize || kf.offset > indexOffset
+            || kf.size > indexOffset - kf.offset || kf.resume != kf.offset + kf.size) {
+            m_keyframes.clear(); // don't seek on a bad index; plain playback still works
+            return;
+        }
+        m_keyframes.push_back(kf);
+    }
+}
+
+void ReplayDecoder::resumeAt(const ReplayKeyframe& kf) {
+    m_pos      = static_cast<std::size_t>(kf.resume);
+    m_timeUs   = kf.timeUs;
+    m_result   = {};
+    m_finished = false;
+    m_error    = false;
+}
+
+bool ReplayDecoder::readVarint(std::uint64_t& out) {
+    out = 0;
+    for (unsigned shift = 0; shift < 64 && m_pos < m_end; shift += 7) {
+        const std::uint8_t b = m_bytes[m_pos++];
+        out |= std::uint64_t{b & 0x7Fu} << shift;
+        if (!(b & 0x80))
+            return true;
+    }
+    m_error = true;
+    return false;
+}
+
+bool ReplayDecoder::next(InputEvent& out) {
+    if (m_finished || m_error)
+        return false;
+
+    std::uint64_t rec;
+    if (!readVarint(rec))
+        return false;
+
+    auto code = static_cast<std::uint8_t>(rec & 0xF);
+    m_timeUs += static_cast<std::int64_t>(rec >> 4);
+
+    // keyframes are only for seeking: step over them
+    while (code == kCodeKeyframe) {
+        std::uint64_t size;
+        if (!readVarint(size) || size > m_end - m_pos) {
+            m_error = true;
+            return false;
+        }
+        m_pos += static_cast<std::size_t>(size);
+        if (!readVarint(rec))
+            return false;
+        code = static_cast<std::uint8_t>(rec & 0xF);
+        m_timeUs += static_cast<std::int64_t>(rec >> 4);
+    }
+
+    if (code == kCodeEnd) {
+        std::uint64_t lines, pieces, sprintUs;
+        if (!readVarint(lines) || !readVarint(pieces) || !readVarint(sprintUs) || m_pos >= m_end) {
+            m_error = true;
+            return false;
+        }
+        m_result.endTimeUs    = m_timeUs;
+        m_result.lines        = static_cast<std::uint32_t>(lines);
+        m_result.pieces       = static_cast<std::uint32_t>(pieces);
+        m_result.sprintTimeUs = static_cast<std::int64_t>(sprintUs);
+        m_result.gameOver     = (m_bytes[m_pos++] & 1) != 0;
+        m_finished = true;
+        return false;
+    }
+
+    out.timeUs = m_timeUs;
+    out.seq    = 0;
+    if (code < kCodeReleaseBase) {
+        out.action  = static_cast<InputAction>(code);
+        out.pressed = true;
+    } else if (code < kCodeReleaseBase + 3) {
+        static constexpr InputAction kReleasable[] = {InputAction::Left, InputAction::Right, InputAction::SoftDrop};
+        out.action  = kReleasable[code - kCodeReleaseBase];
+        out.pressed = false;
+    } else {
+        m_error = true;
+        return false;
+    }
+    return true;
+}
+
+// ---- player ---------------------------------------------------------------
+
+bool ReplayPlayer::open(std::span<const std::uint8_t> bytes) {
+    if (!m_decoder.open(bytes))
+        return false;
+    const ReplayHeader& h = m_decoder.header();
+    m_sim.reset(h.runType, h.settings, h.seed);
+    m_hasPending = m_decoder.next(m_pending);
+    return true;
+}
+
+void ReplayPlayer::advanceTo(std::int64_t timeUs) {
+    while (m_hasPending && m_pending.timeUs <= timeUs) {
+        m_sim.advanceTo(m_pending.timeUs);
+        m_sim.apply(m_pending);
+        m_hasPending = m_decoder.next(m_pending);
+    }
+    m_sim.advanceTo(timeUs);
+}
+
+void ReplayPlayer::runToEnd() {
+    while (m_hasPending) {
+        m_sim.advanceTo(m_pending.timeUs);
+        m_sim.apply(m_pending);
+        m_hasPending = m_decoder.next(m_pending);
+    }
+    if (m_decoder.finished())
+        m_sim.advanceTo(m_decoder.result().endTimeUs);
+}
+
+void ReplayPlayer::restart(const ReplayKeyframe* kf) {
+    Simulation::Checkpoint cp;
+    if (kf && unpackCheckpoint(m_decoder.bytes().subspan(static_cast<std::size_t>(kf->offset), kf->size), cp)) {
+        m_sim.restore(cp);
+        m_decoder.resumeAt(*kf);
+    } else {
+        const ReplayHeader& h = m_decoder.header();
+        m_sim.reset(h.runType, h.settings, h.seed);
+        m_decoder.resumeAt(ReplayKeyframe{0, 0, 0, kReplayHeaderSize, kReplayHeaderSize});
+    }
+    m_hasPending = m_decoder.next(m_pending);
+}
+
+void ReplayPlayer::seek(std::int64_t timeUs) {
+    const auto& kfs = m_decoder.keyframes();
+    const auto it = std::upper_bound(kfs.begin(), kfs.end(), timeUs,
+                                     [](std::int64_t t, const ReplayKeyframe& k) { return t < k.timeUs; });
+    const ReplayKeyframe* kf = (it == kfs.begin()) ? nullptr : &*std::prev(it);
+
+    // already past that keyframe and not beyond the target: just play on
+    const std::int64_t now = m_sim.timeUs();
+    if (now > timeUs || now < (kf ? kf->timeUs : 0))
+        restart(kf);
+    advanceTo(timeUs);
+}
+
+void ReplayPlayer::seekToPiece(int pieces) {
+    const auto& kfs = m_decoder.keyframes();
+    const auto it = std::upper_bound(kfs.begin(), kfs.end(), pieces,
+                                     [](int n, const ReplayKeyframe& k) { return n < static_cast<int>(k.pieces); });
+    const ReplayKeyframe* kf = (it == kfs.begin()) ? nullptr : &*std::prev(it);
+
+    const int now = m_sim.state().piecesPlaced;
+    if (now > pieces || now < (kf ? static_cast<int>(kf->pieces) : 0))
+        restart(kf);
+
+    // pieces lock on inputs and on gravity alike: walk the step grid
+    while (m_sim.state().piecesPlaced < pieces && !m_sim.state().gameOver) {
+        const std::int64_t end = m_decoder.finished() ? m_decoder.result().endTimeUs
+                                                      : std::numeric_limits<std::int64_t>::max();
+        if (!m_hasPending && (m_decoder.error() || m_sim.timeUs() >= end))
+            break;
+        advanceTo(m_sim.timeUs() + Simulation::kStepUs);
+    }
+}
+
+} // namespace Tetris
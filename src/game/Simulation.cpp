@@ -0,0 +1,320 @@
+#include "game/Simulation.hpp"
+#include "game/Gravity.hpp"
+#include "game/Logic.hpp"
+#include "game/Rotate.hpp"
+#include "game/Kicks.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// Trace markers around the Logic.hpp steps. Only the game defines
+// TETRIS_TRACE_GAME; the headless tools build this file without core/.
+#ifdef TETRIS_TRACE_GAME
+#include "core/Trace.hpp"
+#define GAME_TRACE_SCOPE(name) TETRIS_TRACE_SCOPE_CAT(name, "game")
+#else
+#define GAME_TRACE_SCOPE(name) static_cast<void>(0)
+#endif
+
+namespace Tetris {
+
+// simple move helper
+static bool tryMove(GameState& s, int dx, int dy) {
+    auto p = s.active;
+    p.x += dx;
+    p.y += dy;
+    if (!blocked(s, p)) {
+        s.active = p;
+        return true;
+    }
+    return false;
+}
+
+// spawn next piece; if it collides immediately, flag game over
+static void spawnOrGameOver(GameState& s) {
+    {
+        GAME_TRACE_SCOPE("spawn");
+        spawn(s);  // from Logic.hpp
+    }
+
+    if (blocked(s, s.active)) {
+        s.gameOver = true;
+    }
+}
+
+void Simulation::reset(RunType run, const MoveSettings& settings, std::uint64_t seed) {
+    m_state = GameState{};
+    m_state.bag                = SevenBag(seed);
+    m_state.runType            = run;
+    m_state.sprintTargetLines  = 40;
+    m_state.sprintTimerRunning = (run == RunType::Sprint);
+    if (run == RunType::Endless)
+        m_state.rowIntervalUs = rowIntervalUsForLevel(m_state.level);
+
+    m_settings   = settings;
+    m_dasUs      = std::llround(std::max(settings.das, 0.f) * 1e6f);
+    m_arrUs      = std::llround(std::max(settings.arr, 0.f) * 1e6f);
+    m_leftState  = {};
+    m_rightState = {};
+    m_softDropHeld = false;
+    m_timeUs     = 0;
+    m_inputSeq   = 0;
+
+    spawn(m_state);
+    settle();
+}
+
+void Simulation::lockResetAfterMove() {
+    if (m_state.grounded && m_state.lockResets < m_state.maxLockResets) {
+        m_state.lockTimerUs = 0;
+        ++m_state.lockResets;
+    }
+}
+
+void Simulation::hardDrop() {
+    m_state.active = dropToGround(m_state);
+    lockAndSpawn();
+}
+
+void Simulation::lockAndSpawn() {
+    int cleared;
+    {
+        GAME_TRACE_SCOPE("lockPiece");
+        lockPiece(m_state);
+    }
+    {
+        GAME_TRACE_SCOPE("clearLines");
+        cleared = clearLines(m_state);
+    }
+    if (cleared > 0 && m_state.runType == RunType::Endless) {
+        const int level = endlessLevel(m_state.totalLinesCleared);
+        if (level != m_state.level) {
+            m_state.level         = level;
+            m_state.rowIntervalUs = rowIntervalUsForLevel(level);
+        }
+    }
+
+    m_state.fallAccUs = 0;
+    spawnOrGameOver(m_state); // spawn() re-enables hold
+    if (!m_state.gameOver)
+        settle();
+}
+
+void Simulation::apply(const InputEvent& in) {
+    m_inputSeq = in.seq;
+
+    // once topped out, gameplay input does nothing
+    if (m_state.gameOver)
+        return;
+
+    if (!in.pressed) {
+        // stop DAS / soft drop when letting go
+        if (in.action == InputAction::Left)     m_leftState  = {};
+        if (in.action == InputAction::Right)    m_rightState = {};
+        if (in.action == InputAction::SoftDrop) m_softDropHeld = false;
+        return;
+    }
+
+    switch (in.action) {
+        case InputAction::Left:
+            // one immediate step, then DAS for left; cancels right
+            if (tryMove(m_state, -1, 0)) lockResetAfterMove();
+            m_leftState  = {true, m_timeUs, 0};
+            m_rightState = {};
+            break;
+
+        case InputAction::Right:
+            if (tryMove(m_state, 1, 0)) lockResetAfterMove();
+            m_rightState = {true, m_timeUs, 0};
+            m_leftState  = {};
+            break;
+
+        case InputAction::SoftDrop:
+            // one cell now, then gravity x SDF while held (step())
+            m_softDropHeld = true;
+            if (m_settings.sdf >= kSdfInstant)
+                sonicDrop();
+            else
+                tryMove(m_state, 0, -1);
+            break;
+
+        case InputAction::HardDrop:
+            hardDrop();
+            break;
+
+        // rotations with SRS-X 180s
+        case InputAction::RotateCW:
+            if (tryRotateWithKicks(m_state, +1, Kick180Mode::SRSX_180)) lockResetAfterMove();
+            break;
+        case InputAction::RotateCCW:
+            if (tryRotateWithKicks(m_state, -1, Kick180Mode::SRSX_180)) lockResetAfterMove();
+            break;
+        case InputAction::Rotate180:
+            if (tryRotateWithKicks(m_state, +2, Kick180Mode::SRSX_180)) lockResetAfterMove();
+            break;
+
+        case InputAction::Hold:
+            holdPiece(m_state);
+            break;
+    }
+
+    if (!m_state.gameOver)
+        settle();
+}
+
+std::int64_t Simulation::nextShiftUs(const MoveKeyState& st) const {
+    // ARR = 0: once charged the piece is re-slid after every step, nothing
+    // to schedule
+    if (!st.held || (m_arrUs == 0 && st.shifts > 0))
+        return std::numeric_limits<std::int64_t>::max();
+    return st.pressUs + m_dasUs + st.shifts * m_arrUs;
+}
+
+void Simulation::applyDueShifts(MoveKeyState& st, int dir) {
+    if (!st.held)
+        return;
+    const std::int64_t charged = m_timeUs - st.pressUs - m_dasUs;
+    if (charged < 0)
+        return;
+
+    // shifts due by now: 1 at DAS, then one per ARR. With ARR = 0 all of
+    // them are due at once; a piece can't travel further than the board.
+    const std::int64_t due = (m_arrUs > 0)
+                           ? charged / m_arrUs + 1
+                           : st.shifts + COLS;
+    if (due <= st.shifts)
+        return;
+
+    // blocked shifts are used up, not replayed once the way clears
+    const std::int64_t n = std::min<std::int64_t>(due - st.shifts, COLS);
+    st.shifts = due;
+    if (shiftBy(dir, static_cast<int>(n)))
+        lockResetAfterMove();
+}
+
+bool Simulation::shiftBy(int dir, int cells) {
+    const int d = std::min(cells, distanceToObstruction(m_state, m_state.active, dir, 0));
+    if (d <= 0)
+        return false;
+    m_state.active.x += dir * d;
+    return true;
+}
+
+void Simulation::sonicDrop() {
+    const int fell = distanceToObstruction(m_state, m_state.active, 0, -1);
+    m_state.active.y -= fell;
+    m_state.fallAccUs = 0;
+
+    // resting now: start lock delay without waiting for a gravity step. A
+    // piece that fell (slid off a ledge) lands fresh, as it would under
+    // gravity -- only one that stayed put keeps its timer and resets.
+    if (!m_state.grounded || fell > 0) {
+        m_state.grounded    = true;
+        m_state.lockTimerUs = 0;
+    }
+    if (fell > 0)
+        m_state.lockResets = 0;
+}
+
+std::int64_t Simulation::currentRowIntervalUs() const {
+    if (!m_softDropHeld || m_settings.sdf <= 1.f)
+        return m_state.rowIntervalUs;
+    return std::max<std::int64_t>(1, std::llround(static_cast<double>(m_state.rowIntervalUs) / m_settings.sdf));
+}
+
+void Simulation::settle() {
+    const bool instantSoftDrop = m_softDropHeld && m_settings.sdf >= kSdfInstant;
+    if (instantSoftDrop || currentRowIntervalUs() <= kInstantRowUs)
+        sonicDrop();
+}
+
+void Simulation::advanceTo(std::int64_t timeUs) {
+    while (m_timeUs < timeUs) {
+        // stop at the next grid point and the next auto-shift instant, if
+        // either falls in this span
+        const std::int64_t grid  = (m_timeUs / kStepUs + 1) * kStepUs;
+        const std::int64_t until = std::min({timeUs, grid, nextShiftUs(m_leftState), nextShiftUs(m_rightState)});
+        const std::int64_t to    = std::max(until, m_timeUs + 1);
+
+        step(to - m_timeUs);
+        m_timeUs = to;
+
+        if (!m_state.gameOver) {
+            applyDueShifts(m_leftState,  -1);
+            applyDueShifts(m_rightState, +1);
+            settle();
+        }
+    }
+}
+
+void Simulation::step(std::int64_t dtUs) {
+    // once gameOver is set, freeze logic
+    if (m_state.gameOver)
+        return;
+
+    // Sprint timer
+    if (m_state.runType == RunType::Sprint && m_state.sprintTimerRunning) {
+        m_state.sprintTimeUs += dtUs;
+    }
+
+    // gravity: whole rows due since the last step, moved in one go. At 20G
+    // (or instant soft drop) the piece is simply kept on the ground.
+    const std::int64_t interval = currentRowIntervalUs();
+    if (interval <= kInstantRowUs || (m_softDropHeld && m_settings.sdf >= kSdfInstant)) {
+        sonicDrop();
+    } else if (!m_state.grounded) {
+        m_state.fallAccUs += dtUs;
+        if (m_state.fallAccUs >= interval) {
+            const std::int64_t rows = m_state.fallAccUs / interval;
+            m_state.fallAccUs -= rows * interval;
+            const int room = distanceToObstruction(m_state, m_state.active, 0, -1);
+            m_state.active.y -= static_cast<int>(std::min<std::int64_t>(rows, room));
+        }
+    }
+
+    // lock delay runs while the piece rests on something
+    if (canMove(m_state, m_state.active, 0, -1)) {
+        if (m_state.grounded) {
+            // slid off a ledge → unground
+            m_state.grounded    = false;
+            m_state.lockTimerUs = 0;
+            m_state.lockResets  = 0;
+        }
+        return;
+    }
+
+    if (!m_state.grounded) {
+        // just landed: the lock timer starts now
+        m_state.grounded    = true;
+        m_state.lockTimerUs = 0;
+        m_state.fallAccUs   = 0;
+        return;
+    }
+
+    m_state.lockTimerUs += dtUs;
+    if (m_state.lockTimerUs >= m_state.lockDelayUs) {
+        // lock + clear + spawn; top-out if spawn overlaps
+        lockAndSpawn();
+    }
+}
+
+Simulation::Checkpoint Simulation::checkpoint() const {
+    return {m_state, m_leftState, m_rightState, m_softDropHeld, m_timeUs};
+}
+
+void Simulation::restore(const Checkpoint& cp) {
+    m_state        = cp.state;
+    m_leftState    = cp.left;
+    m_rightState   = cp.right;
+    m_softDropHeld = cp.softDropHeld;
+    m_timeUs       = cp.timeUs;
+}
+
+void Simulation::snapshot(RenderSnapshot& out) const {
+    fillSnapshot(m_state, out);
+    out.timeUs   = m_timeUs;
+    out.inputSeq = m_inputSeq;
+}
+
+} // namespace Tetris
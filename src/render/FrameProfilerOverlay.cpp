@@ -0,0 +1,107 @@
+#include "render/FrameProfilerOverlay.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+
+namespace Tetris {
+
+// graph geometry (screen space, bottom-left corner)
+static constexpr float kGraphW    = 480.f;
+static constexpr float kGraphH    = 120.f;
+static constexpr float kGraphMaxMs = 33.3f; // top of the graph
+static constexpr float kMargin    = 12.f;
+
+FrameProfilerOverlay::FrameProfilerOverlay(InstrumentedTarget& target, const FrameProfiler& profiler)
+    : m_target(target)
+    , m_profiler(profiler)
+{
+    m_panel.setFillColor(sf::Color(0, 0, 0, 170));
+}
+
+void FrameProfilerOverlay::setFont(const sf::Font& font) {
+    m_text = std::make_unique<sf::Text>(font, "", 14);
+    m_text->setFillColor(sf::Color(220, 230, 255));
+}
+
+void FrameProfilerOverlay::update(float dt) {
+    if (!m_visible)
+        return;
+    m_textAccum += dt;
+    if (m_textAccum >= kTextInterval) {
+        m_textAccum = 0.f;
+        rebuildText();
+    }
+}
+
+void FrameProfilerOverlay::rebuildText() {
+    if (!m_text)
+        return;
+
+    auto ms = [](std::uint64_t ns) { return static_cast<double>(ns) / 1e6; };
+
+    char buf[96];
+    std::snprintf(buf, sizeof(buf), "frame profile (%llu frames)   F4: reset\n",
+                  static_cast<unsigned long long>(m_profiler.histogram(FramePhase::Frame).count()));
+    std::string out = buf;
+    out += "phase        p50 ms    p99 ms    max ms\n";
+    for (std::size_t i = 0; i < kFramePhaseCount; ++i) {
+        const auto p = static_cast<FramePhase>(i);
+        const auto& h = m_profiler.histogram(p);
+        std::snprintf(buf, sizeof(buf), "%-9s %9.3f %9.3f %9.3f\n",
+                      framePhaseName(p), ms(h.percentileNs(0.50)), ms(h.percentileNs(0.99)), ms(h.maxNs()));
+        out += buf;
+    }
+    m_target.setString(*m_text, out);
+}
+
+void FrameProfilerOverlay::rebuildGraph() {
+    const float winH   = static_cast<float>(m_target.getSize().y);
+    const float left   = kMargin;
+    const float bottom = winH - kMargin;
+
+    auto yFor = [&](float frameMs) {
+        return bottom - std::min(frameMs, kGraphMaxMs) / kGraphMaxMs * kGraphH;
+    };
+
+    // vertex count is fixed: this only rewrites positions, never allocates
+    const float step = kGraphW / static_cast<float>(FrameProfiler::kGraphFrames - 1);
+    for (std::size_t i = 0; i < FrameProfiler::kGraphFrames; ++i) {
+        const float v = m_profiler.recentFrameMs(i);
+        m_graph[i].position = {left + step * static_cast<float>(i), yFor(v)};
+        m_graph[i].color    = v > 1000.f / 60.f ? sf::Color(255, 90, 90) : sf::Color(120, 230, 120);
+    }
+
+    const sf::Color refColor(255, 255, 255, 70);
+    const float y240 = yFor(1000.f / 240.f);
+    const float y60  = yFor(1000.f / 60.f);
+    m_refLines[0] = sf::Vertex{{left, y240}, refColor};
+    m_refLines[1] = sf::Vertex{{left + kGraphW, y240}, refColor};
+    m_refLines[2] = sf::Vertex{{left, y60}, refColor};
+    m_refLines[3] = sf::Vertex{{left + kGraphW, y60}, refColor};
+}
+
+void FrameProfilerOverlay::draw() {
+    if (!m_visible)
+        return;
+
+    rebuildGraph();
+
+    const float winH = static_cast<float>(m_target.getSize().y);
+    float panelTop = winH - kMargin - kGraphH;
+    if (m_text) {
+        const auto b = m_text->getLocalBounds();
+        m_text->setPosition(sf::Vector2f{kMargin, panelTop - b.size.y - 16.f});
+        panelTop -= b.size.y + 20.f;
+    }
+
+    m_panel.setPosition(sf::Vector2f{kMargin - 6.f, panelTop - 6.f});
+    m_panel.setSize(sf::Vector2f{kGraphW + 12.f, winH - kMargin - panelTop + 12.f});
+
+    m_target.draw(m_panel);
+    m_target.draw(m_refLines);
+    m_target.draw(m_graph);
+    if (m_text) m_target.draw(*m_text);
+}
+
+} // namespace Tetris
@@ -1,85 +1,56 @@
 #include "render/Hud.hpp"
 #include "game/Pieces.hpp"      // Tetromino, shape()
-#include "game/Logic.hpp"       // peekNextPieces, RunType, etc.
+#include "game/Snapshot.hpp"    // RenderSnapshot, RunType, etc.
 #include "render/Colors.hpp"
 
-#include <SFML/Graphics/RectangleShape.hpp>
-#include <filesystem>
+#include <algorithm>
 #include <sstream>
 
-namespace fs = std::filesystem;
-
 namespace Tetris {
 
-// ---- font search ----
-static fs::path findFont() {
-    try {
-        if (fs::exists("resources/fonts/DejaVuSans.ttf"))
-            return "resources/fonts/DejaVuSans.ttf";
-        if (fs::exists("./resources/fonts/DejaVuSans.ttf"))
-            return "./resources/fonts/DejaVuSans.ttf";
-        if (fs::exists("../resources/fonts/DejaVuSans.ttf"))
-            return "../resources/fonts/DejaVuSans.ttf";
-    } catch (...) {
-    }
-    return {};
+// ---- hold / next panel layout ----
+static constexpr float kHoldX     = 16.f;
+static constexpr float kPanelY    = 140.f; // moved down a bit for sprint text
+static constexpr float kPanelW    = 96.f;
+static constexpr float kHoldH     = 96.f;
+static constexpr float kNextSlotH = 64.f;
+
+static const sf::Color kPanelFill(0, 0, 0, 80);
+static const sf::Color kPanelOutline(80, 80, 80);
+
+// Write an axis-aligned rect as two triangles into out[0..5].
+static void writeRect(sf::Vertex* out, float x, float y, float w, float h, sf::Color c) {
+    const sf::Vector2f tl{x, y}, tr{x + w, y}, bl{x, y + h}, br{x + w, y + h};
+    out[0] = {tl, c}; out[1] = {tr, c}; out[2] = {bl, c};
+    out[3] = {bl, c}; out[4] = {tr, c}; out[5] = {br, c};
 }
 
-Hud::Hud(sf::RenderWindow& window)
-: m_window(window)
-{
-    const auto fontPath = findFont();
-    if (!fontPath.empty() && m_font.openFromFile(fontPath.string())) {
-        m_fontOk = true;
-
-        // FPS (top-left)
-        m_fps = std::make_unique<sf::Text>(m_font, "", 16);
-        m_fps->setFillColor(sf::Color(200, 200, 200));
-        m_fps->setPosition(sf::Vector2f{8.f, 8.f});
-
-        // Lines
-        m_linesText = std::make_unique<sf::Text>(m_font, "", 18);
-        m_linesText->setFillColor(sf::Color(230, 230, 230));
-        m_linesText->setPosition(sf::Vector2f{8.f, 32.f});
-
-        // "SPRINT 40" label
-        m_sprintText = std::make_unique<sf::Text>(m_font, "SPRINT 40", 20);
-        m_sprintText->setFillColor(sf::Color(230, 230, 0));
-        m_sprintText->setPosition(sf::Vector2f{8.f, 56.f});
-
-        // sprint info (time + finished)
-        m_sprintInfo = std::make_unique<sf::Text>(m_font, "", 18);
-        m_sprintInfo->setFillColor(sf::Color(230, 230, 230));
-        m_sprintInfo->setPosition(sf::Vector2f{8.f, 80.f});
-
-    } else {
-        m_fontOk = false;
-        m_fps.reset();
-        m_linesText.reset();
-        m_sprintText.reset();
-        m_sprintInfo.reset();
-    }
+static void appendRect(sf::VertexArray& va, float x, float y, float w, float h, sf::Color c) {
+    sf::Vertex v[6];
+    writeRect(v, x, y, w, h, c);
+    for (const auto& vert : v) va.append(vert);
 }
 
-void Hud::update(float dt) {
-    m_accum += dt;
-    ++m_frames;
-    if (m_accum >= 0.25f) {
-        const int fps = static_cast<int>(m_frames / m_accum);
-        m_frames = 0;
-        m_accum  = 0.f;
-        if (m_fontOk && m_fps)
-            m_fps->setString(std::to_string(fps) + " FPS");
+// Panel background plus a 1px outline drawn outside it, like
+// RectangleShape with setOutlineThickness(1).
+static void appendPanel(sf::VertexArray& va, float x, float y, float w, float h) {
+    appendRect(va, x, y, w, h, kPanelFill);
+    appendRect(va, x - 1.f, y - 1.f, w + 2.f, 1.f, kPanelOutline); // top
+    appendRect(va, x - 1.f, y + h,   w + 2.f, 1.f, kPanelOutline); // bottom
+    appendRect(va, x - 1.f, y,       1.f,     h,   kPanelOutline); // left
+    appendRect(va, x + w,   y,       1.f,     h,   kPanelOutline); // right
+}
+
+static void appendMesh(sf::VertexArray& va, const MiniPieceMesh& mesh, float x, float y) {
+    for (sf::Vertex v : mesh) {
+        v.position.x += x;
+        v.position.y += y;
+        va.append(v);
     }
 }
 
-// Draw a mini piece (rotation 0) centered in a box.
-static void drawMiniPieceInBox(sf::RenderWindow& window,
-                               Tetromino t,
-                               float boxX,
-                               float boxY,
-                               float boxW,
-                               float boxH)
+// Lay out a mini piece (rotation 0) centered in a boxW x boxH slot.
+static MiniPieceMesh buildMiniPieceMesh(Tetromino t, float boxW, float boxH)
 {
     const auto& sh = shape(t).cells[0];
 
@@ -111,12 +82,13 @@ static void drawMiniPieceInBox(sf::RenderWindow& window,
     const float pieceW = pieceCols * cellSize;
     const float pieceH = pieceRows * cellSize;
 
-    const float originX = boxX + (boxW - pieceW) * 0.5f;
-    const float originY = boxY + (boxH - pieceH) * 0.5f;
+    const float originX = (boxW - pieceW) * 0.5f;
+    const float originY = (boxH - pieceH) * 0.5f;
 
-    sf::RectangleShape rect(sf::Vector2f{cellSize - 2.f, cellSize - 2.f});
-    rect.setFillColor(Colors::pieceColor(t));
+    const sf::Color col = Colors::pieceColor(t);
 
+    MiniPieceMesh mesh{};
+    std::size_t i = 0;
     for (const auto& c : sh) {
         int cx = static_cast<int>(c[0]);
         int cy = static_cast<int>(c[1]);
@@ -124,16 +96,77 @@ static void drawMiniPieceInBox(sf::RenderWindow& window,
         float px = originX + (cx - minX) * cellSize;
         float py = originY + (maxY - cy) * cellSize; // flip y for SFML
 
-        rect.setPosition(sf::Vector2f{px + 1.f, py + 1.f});
-        window.draw(rect);
+        writeRect(&mesh[i], px + 1.f, py + 1.f, cellSize - 2.f, cellSize - 2.f, col);
+        i += 6;
     }
+    return mesh;
 }
 
-void Hud::draw(const GameState& state)
+Hud::Hud(InstrumentedTarget& target)
+: m_target(target)
+{
+    for (int i = 0; i < 7; ++i) {
+        const auto t = static_cast<Tetromino>(i);
+        m_holdMeshes[i] = buildMiniPieceMesh(t, kPanelW, kHoldH);
+        m_nextMeshes[i] = buildMiniPieceMesh(t, kPanelW, kNextSlotH);
+    }
+
+}
+
+void Hud::setFont(const sf::Font& font) {
+    m_fontOk = true;
+
+    // FPS (top-left)
+    m_fps = std::make_unique<sf::Text>(font, "", 16);
+    m_fps->setFillColor(sf::Color(200, 200, 200));
+    m_fps->setPosition(sf::Vector2f{8.f, 8.f});
+
+    // Lines
+    m_linesText = std::make_unique<sf::Text>(font, "", 18);
+    m_linesText->setFillColor(sf::Color(230, 230, 230));
+    m_linesText->setPosition(sf::Vector2f{8.f, 32.f});
+
+    // "SPRINT 40" label
+    m_sprintText = std::make_unique<sf::Text>(font, "SPRINT 40", 20);
+    m_sprintText->setFillColor(sf::Color(230, 230, 0));
+    m_sprintText->setPosition(sf::Vector2f{8.f, 56.f});
+
+    // sprint info (time + finished)
+    m_sprintInfo = std::make_unique<sf::Text>(font, "", 18);
+    m_sprintInfo->setFillColor(sf::Color(230, 230, 230));
+    m_sprintInfo->setPosition(sf::Vector2f{8.f, 80.f});
+
+    // diagnostics (bottom-left, positioned at draw time)
+    m_diagText = std::make_unique<sf::Text>(font, "", 14);
+    m_diagText->setFillColor(sf::Color(200, 200, 120));
+}
+
+void Hud::setDiagnostics(const std::string& text) {
+    m_diagShown = !text.empty();
+    if (m_fontOk && m_diagText)
+        m_target.setString(*m_diagText, text);
+}
+
+void Hud::update(float dt) {
+    m_accum += dt;
+    ++m_frames;
+    if (m_accum >= 0.25f) {
+        const int fps = static_cast<int>(m_frames / m_accum);
+        m_frames = 0;
+        m_accum  = 0.f;
+        if (m_fontOk && m_fps)
+            m_target.setString(*m_fps, std::to_string(fps) + " FPS");
+    }
+}
+
+void Hud::draw(const RenderSnapshot& state)
 {
     // --- update sprint HUD text ---
     if (m_fontOk && m_linesText) {
-    	m_linesText->setString("Lines: " + std::to_string(state.totalLinesCleared));
+    	std::string lines = "Lines: " + std::to_string(state.totalLinesCleared);
+    	if (state.runType == RunType::Endless)
+    	    lines += "   Level " + std::to_string(state.level);
+    	m_target.setString(*m_linesText, lines);
 	}
 
     if (m_fontOk && state.runType == RunType::Sprint && m_sprintInfo) {
@@ -144,67 +177,71 @@ void Hud::draw(const GameState& state)
         if (state.gameOver && state.totalLinesCleared >= 40) {
             oss << "\nFinished!";
         }
-        m_sprintInfo->setString(oss.str());
+        if (state.race.shown) {
+            if (state.race.finished)
+                oss << "\nPB: " << state.race.sprintTime << " s";
+            else
+                oss << "\nPB: " << state.race.totalLinesCleared << " lines";
+        }
+        m_target.setString(*m_sprintInfo, oss.str());
     }
 
     // draw text overlays
     if (m_fontOk) {
-        if (m_fps)        m_window.draw(*m_fps);
-        if (m_linesText)  m_window.draw(*m_linesText);
+        if (m_fps)        m_target.draw(*m_fps);
+        if (m_linesText)  m_target.draw(*m_linesText);
         if (state.runType == RunType::Sprint) {
-            if (m_sprintText)  m_window.draw(*m_sprintText);
-            if (m_sprintInfo)  m_window.draw(*m_sprintInfo);
+            if (m_sprintText)  m_target.draw(*m_sprintText);
+            if (m_sprintInfo)  m_target.draw(*m_sprintInfo);
+        }
+        if (m_diagShown && m_diagText) {
+            const float h = m_diagText->getLocalBounds().size.y;
+            m_diagText->setPosition(sf::Vector2f{8.f, static_cast<float>(m_target.getSize().y) - h - 16.f});
+            m_target.draw(*m_diagText);
         }
     }
 
-    // then hold / queue UI
-    drawHold(state);
-    drawNext(state);
+    // then hold / queue UI, one batched draw
+    updatePreview(state);
+    m_target.draw(m_previewVerts);
 }
 
-void Hud::drawHold(const GameState& state) {
-    if (!state.hasHold)
-        return;
-
-    const float boxX = 16.f;
-    const float boxY = 140.f; // moved down a bit for sprint text
-    const float boxW = 96.f;
-    const float boxH = 96.f;
+void Hud::updatePreview(const RenderSnapshot& state) {
+    std::array<Tetromino, kNextShown> upcoming{};
+    std::copy_n(state.next.begin(), kNextShown, upcoming.begin());
+    const unsigned winW = m_target.getSize().x;
 
-    sf::RectangleShape box(sf::Vector2f{boxW, boxH});
-    box.setPosition(sf::Vector2f{boxX, boxY});
-    box.setFillColor(sf::Color(0, 0, 0, 80));
-    box.setOutlineThickness(1.f);
-    box.setOutlineColor(sf::Color(80, 80, 80));
-    m_window.draw(box);
-
-    drawMiniPieceInBox(m_window, state.holdType, boxX, boxY, boxW, boxH);
-}
-
-void Hud::drawNext(const GameState& state) {
-    constexpr int maxShown = 5;
-    auto upcoming = peekNextPieces<maxShown>(state);
+    if (m_previewValid
+        && m_shownHasHold == state.hasHold
+        && (!state.hasHold || m_shownHold == state.holdType)
+        && m_shownNext == upcoming
+        && m_shownWinW == winW) {
+        return;
+    }
 
-    const float slotH   = 64.f;
-    const float boxW    = 96.f;
-    const float boxH    = maxShown * slotH;
+    m_previewValid = true;
+    m_shownHasHold = state.hasHold;
+    m_shownHold    = state.holdType;
+    m_shownNext    = upcoming;
+    m_shownWinW    = winW;
 
-    const float startX  = static_cast<float>(m_window.getSize().x) - boxW - 16.f;
-    const float startY  = 140.f;
+    m_previewVerts.clear();
 
-    sf::RectangleShape outer(sf::Vector2f{boxW, boxH});
-    outer.setPosition(sf::Vector2f{startX, startY});
-    outer.setFillColor(sf::Color(0, 0, 0, 80));
-    outer.setOutlineThickness(1.f);
-    outer.setOutlineColor(sf::Color(80, 80, 80));
-    m_window.draw(outer);
+    if (state.hasHold) {
+        appendPanel(m_previewVerts, kHoldX, kPanelY, kPanelW, kHoldH);
+        appendMesh(m_previewVerts,
+                   m_holdMeshes[static_cast<std::size_t>(state.holdType)],
+                   kHoldX, kPanelY);
+    }
 
-    for (int i = 0; i < maxShown; ++i) {
-        Tetromino t = upcoming[static_cast<std::size_t>(i)];
+    const float nextX = static_cast<float>(winW) - kPanelW - 16.f;
+    appendPanel(m_previewVerts, nextX, kPanelY, kPanelW, kNextShown * kNextSlotH);
 
-        float slotX = startX;
-        float slotY = startY + i * slotH;
-        drawMiniPieceInBox(m_window, t, slotX, slotY, boxW, slotH);
+    for (int i = 0; i < kNextShown; ++i) {
+        const Tetromino t = upcoming[static_cast<std::size_t>(i)];
+        appendMesh(m_previewVerts,
+                   m_nextMeshes[static_cast<std::size_t>(t)],
+                   nextX, kPanelY + i * kNextSlotH);
     }
 }
 
@@ -0,0 +1,18 @@
+#include "render/InstrumentedTarget.hpp"
+
+namespace Tetris {
+
+const char* renderSubsystemName(RenderSubsystem s) {
+    switch (s) {
+        case RenderSubsystem::Playfield: return "playfield";
+        case RenderSubsystem::Hud:       return "hud";
+        case RenderSubsystem::Title:     return "title";
+        case RenderSubsystem::Config:    return "config";
+        case RenderSubsystem::Overlay:   return "overlay";
+        case RenderSubsystem::Other:     return "other";
+        case RenderSubsystem::Count:     break;
+    }
+    return "?";
+}
+
+} // namespace Tetris
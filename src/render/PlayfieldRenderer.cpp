@@ -1,19 +1,18 @@
 #include "render/PlayfieldRenderer.hpp"
 #include "render/Colors.hpp"
 #include "game/Pieces.hpp"
-#include "game/Logic.hpp"
-#include "game/GameState.hpp"
+#include "game/Snapshot.hpp"
 
 namespace Tetris {
 
-PlayfieldRenderer::PlayfieldRenderer(sf::RenderWindow& window)
-    : m_window(window)
+PlayfieldRenderer::PlayfieldRenderer(InstrumentedTarget& target)
+    : m_target(target)
 {
     m_origin = sf::Vector2f{0.f, 0.f};
 }
 
-void PlayfieldRenderer::draw(const GameState& gs) {
-    const auto winSize = m_window.getSize();
+void PlayfieldRenderer::draw(const RenderSnapshot& gs) {
+    const auto winSize = m_target.getSize();
     const float winW = static_cast<float>(winSize.x);
     const float winH = static_cast<float>(winSize.y);
 
@@ -26,6 +25,8 @@ void PlayfieldRenderer::draw(const GameState& gs) {
     m_origin.y = (winH - fieldH) * 0.5f + verticalOffset;
 
     drawGrid();
+    if (gs.race.shown)
+        drawRace(gs.race);
     drawCells(gs);
     drawGhost(gs);
     drawActive(gs);
@@ -45,7 +46,7 @@ void PlayfieldRenderer::drawGrid()
     border.setFillColor(sf::Color::Transparent);
     border.setOutlineColor(Colors::Grid);
     border.setOutlineThickness(2.f);
-    m_window.draw(border);
+    m_target.draw(border);
 
     // grid lines
     sf::Vertex line[2];
@@ -58,7 +59,7 @@ void PlayfieldRenderer::drawGrid()
             px,
             m_origin.y + static_cast<float>(VISIBLE_ROWS) * cell
         }, Colors::Grid);
-        m_window.draw(line, 2, sf::PrimitiveType::Lines);
+        m_target.draw(line, 2, sf::PrimitiveType::Lines);
     }
 
     // horizontals
@@ -69,11 +70,11 @@ void PlayfieldRenderer::drawGrid()
             m_origin.x + static_cast<float>(COLS) * cell,
             py
         }, Colors::Grid);
-        m_window.draw(line, 2, sf::PrimitiveType::Lines);
+        m_target.draw(line, 2, sf::PrimitiveType::Lines);
     }
 }
 
-void PlayfieldRenderer::drawCells(const GameState& gs)
+void PlayfieldRenderer::drawCells(const RenderSnapshot& gs)
 {
     const float cell = static_cast<float>(CELL);
     sf::RectangleShape rect(sf::Vector2f{cell - 2.f, cell - 2.f});
@@ -89,12 +90,44 @@ void PlayfieldRenderer::drawCells(const GameState& gs)
                 m_origin.x + static_cast<float>(x) * cell + 1.f,
                 m_origin.y + static_cast<float>(screenRow) * cell + 1.f
             });
-            m_window.draw(rect);
+            m_target.draw(rect);
         }
     }
 }
 
-void PlayfieldRenderer::drawActive(const GameState& gs)
+void PlayfieldRenderer::drawRace(const RaceSnapshot& race)
+{
+    const float cell = static_cast<float>(CELL);
+    sf::RectangleShape rect(sf::Vector2f{cell - 2.f, cell - 2.f});
+
+    auto drawCell = [&](int x, int y, sf::Color c) {
+        c.a = 45;
+        rect.setFillColor(c);
+        rect.setPosition(sf::Vector2f{
+            m_origin.x + static_cast<float>(x) * cell + 1.f,
+            m_origin.y + static_cast<float>(VISIBLE_ROWS - 1 - y) * cell + 1.f
+        });
+        m_target.draw(rect);
+    };
+
+    for (int y = 0; y < VISIBLE_ROWS; ++y) {
+        for (int x = 0; x < COLS; ++x) {
+            const auto v = race.grid[y * COLS + x];
+            if (v != 0) drawCell(x, y, colorFromCell(v));
+        }
+    }
+
+    if (race.finished)
+        return;
+    for (const auto& c : shape(race.active.type).cells[race.active.rot]) {
+        const int gx = race.active.x + c[0];
+        const int gy = race.active.y + c[1];
+        if (gx >= 0 && gx < COLS && gy >= 0 && gy < VISIBLE_ROWS)
+            drawCell(gx, gy, Colors::pieceColor(race.active.type));
+    }
+}
+
+void PlayfieldRenderer::drawActive(const RenderSnapshot& gs)
 {
     const float cell = static_cast<float>(CELL);
 
@@ -116,15 +149,15 @@ void PlayfieldRenderer::drawActive(const GameState& gs)
             m_origin.x + static_cast<float>(gx) * cell + 1.f,
             m_origin.y + static_cast<float>(screenRow) * cell + 1.f
         });
-        m_window.draw(rect);
+        m_target.draw(rect);
     }
 }
 
-void PlayfieldRenderer::drawGhost(const GameState& gs)
+void PlayfieldRenderer::drawGhost(const RenderSnapshot& gs)
 {
     const float cell = static_cast<float>(CELL);
 
-    ActivePiece ghost = dropToGround(gs);
+    const ActivePiece& ghost = gs.ghost;
     const auto& sh = shape(ghost.type).cells[ghost.rot];
 
     sf::RectangleShape rect(sf::Vector2f{cell - 2.f, cell - 2.f});
@@ -146,7 +179,7 @@ void PlayfieldRenderer::drawGhost(const GameState& gs)
                        + 1.f;
 
         rect.setPosition(sf::Vector2f{px, py});
-        m_window.draw(rect);
+        m_target.draw(rect);
     }
 }
 
@@ -0,0 +1,70 @@
+#include "render/RenderStatsOverlay.hpp"
+
+#include <cstdio>
+#include <sstream>
+
+namespace Tetris {
+
+void RenderStatsOverlay::setFont(const sf::Font& font) {
+    m_text = std::make_unique<sf::Text>(font, "", 14);
+    m_text->setFillColor(sf::Color(220, 255, 220));
+    m_text->setPosition(sf::Vector2f{12.f, 260.f});
+
+    m_panel.setFillColor(sf::Color(0, 0, 0, 170));
+    m_panel.setPosition(sf::Vector2f{4.f, 254.f});
+}
+
+void RenderStatsOverlay::record(const RenderStats& frame) {
+    m_history[m_recorded % kHistory] = frame;
+    ++m_recorded;
+}
+
+void RenderStatsOverlay::draw() {
+    if (!m_visible || !m_text)
+        return;
+
+    const RenderStats& s = m_target.lastFrame();
+
+    char buf[96];
+    std::string out = "render stats (last frame)   F2: dump CSV\n"
+                      "subsystem    draws   verts  binds  texts\n";
+    auto row = [&](const char* name, const RenderCounters& c) {
+        std::snprintf(buf, sizeof(buf), "%-10s %7u %7u %6u %6u\n",
+                      name, c.drawCalls, c.vertices, c.textureBinds, c.textRebuilds);
+        out += buf;
+    };
+    for (std::size_t i = 0; i < kRenderSubsystemCount; ++i) {
+        const auto& c = s.bySubsystem[i];
+        if (c.drawCalls == 0 && c.textRebuilds == 0) continue;
+        row(renderSubsystemName(static_cast<RenderSubsystem>(i)), c);
+    }
+    row("total", s.total());
+
+    m_target.setString(*m_text, out);
+
+    const auto b = m_text->getLocalBounds();
+    m_panel.setSize(sf::Vector2f{b.size.x + 24.f, b.size.y + 24.f});
+
+    m_target.draw(m_panel);
+    m_target.draw(*m_text);
+}
+
+std::string RenderStatsOverlay::csv() const {
+    std::ostringstream out;
+    out << "frame,subsystem,draw_calls,vertices,texture_binds,text_rebuilds\n";
+
+    const std::uint64_t count = m_recorded < kHistory ? m_recorded : kHistory;
+    const std::uint64_t first = m_recorded - count;
+    for (std::uint64_t f = first; f < m_recorded; ++f) {
+        const RenderStats& s = m_history[f % kHistory];
+        for (std::size_t i = 0; i < kRenderSubsystemCount; ++i) {
+            const auto& c = s.bySubsystem[i];
+            out << f << ',' << renderSubsystemName(static_cast<RenderSubsystem>(i)) << ','
+                << c.drawCalls << ',' << c.vertices << ','
+                << c.textureBinds << ',' << c.textRebuilds << '\n';
+        }
+    }
+    return out.str();
+}
+
+} // namespace Tetris
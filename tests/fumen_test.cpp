@@ -0,0 +1,141 @@
+// tests/fumen_test.cpp -- fumen codec and board import / export, no window
+#include "game/Fumen.hpp"
+#include "game/Logic.hpp"
+#include "game/Simulation.hpp"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace Tetris;
+
+static int g_failures = 0;
+
+static void check(bool ok, const char* what) {
+    if (!ok) {
+        std::fprintf(stderr, "FAIL: %s\n", what);
+        ++g_failures;
+    }
+}
+
+// decode, then encode again: must give back the same string
+static std::vector<FumenPage> roundTrip(const char* fumen) {
+    std::vector<FumenPage> pages;
+    check(decodeFumen(fumen, pages), fumen);
+    std::string again;
+    encodeFumen(pages, again);
+    if (again != fumen) {
+        std::fprintf(stderr, "FAIL: %s re-encodes as %s\n", fumen, again.c_str());
+        ++g_failures;
+    }
+    return pages;
+}
+
+// one row of a page, '.' empty, else the piece letter ('X' garbage)
+static std::string row(const FumenPage& page, int y) {
+    std::string out;
+    for (int x = 0; x < kFumenWidth; ++x)
+        out += ".ILOZTJSX"[static_cast<int>(page.field[fumenIndex(x, y)])];
+    return out;
+}
+
+static void emptyPage() {
+    const auto pages = roundTrip("v115@vhAAgH");
+    check(pages.size() == 1, "empty: one page");
+    check(pages[0].piece == FumenPiece::Empty && pages[0].lock && pages[0].colorize, "empty: default flags");
+    check(pages[0].field == FumenPage{}.field, "empty: empty field");
+
+    std::vector<FumenPage> linked;
+    check(decodeFumen("https://fumen.zui.jp/?v115@vhAAgH", linked) && linked.size() == 1, "empty: as a link");
+    check(!decodeFumen("v110@vhAAgH", linked), "rejects other versions");
+    check(!decodeFumen("v115@vhA", linked), "rejects a truncated page");
+}
+
+// T at spawn on an empty field with a quiz comment, then an empty page
+static void quizPage() {
+    const auto pages = roundTrip("v115@vhAVQYYAFLDmClcJSAVDEHBEooRBUoAVBJ3jFDVhQLHeSLNeAgWAA");
+    check(pages.size() == 2, "quiz: two pages");
+    const FumenPage& p = pages[0];
+    check(p.piece == FumenPiece::T && p.rotation == 0 && p.x == 4 && p.y == 0 && p.lock, "quiz: T piece");
+    check(p.comment == "#Q=[](T)IOSZ", "quiz: comment");
+
+    FumenQuiz quiz;
+    check(parseFumenQuiz(p.comment, quiz), "quiz: parses");
+    check(quiz.hold == FumenPiece::Empty && quiz.current == FumenPiece::T && quiz.count == 4
+          && quiz.next[0] == FumenPiece::I && quiz.next[3] == FumenPiece::Z, "quiz: pieces");
+    check(advanceFumenQuiz(quiz, FumenPiece::T) && quiz.current == FumenPiece::I && quiz.count == 3,
+          "quiz: advances");
+    std::string text;
+    formatFumenQuiz(quiz, text);
+    check(text == "#Q=[](I)OSZ", "quiz: formats");
+}
+
+// an O locked with rise and mirror: the next page shows the result without
+// any field change of its own
+static void mirrorRisePage() {
+    const auto pages = roundTrip("v115@RhglIeilHeI8T1OvhAAgH");
+    check(pages.size() == 2, "mirror/rise: two pages");
+    const FumenPage& p = pages[0];
+    check(p.piece == FumenPiece::O && p.x == 8 && p.y == 0 && p.lock && p.rise && p.mirror, "mirror/rise: flags");
+    check(row(p, 1) == "L........." && row(p, 0) == "LLL......." && row(p, -1) == ".XXXXXXXXX",
+          "mirror/rise: first field");
+
+    const FumenPage& next = pages[1];
+    check(row(next, 3) == "..........", "mirror/rise: row 3");
+    check(row(next, 2) == "OO.......L", "mirror/rise: row 2");
+    check(row(next, 1) == "OO.....LLL", "mirror/rise: row 1");
+    check(row(next, 0) == "XXXXXXXXX.", "mirror/rise: garbage risen and mirrored");
+    check(row(next, -1) == "..........", "mirror/rise: garbage row empty");
+}
+
+// a few pieces into a seeded run, then out to a fumen and back
+static void stateRoundTrip() {
+    Simulation sim;
+    sim.reset(RunType::Sprint, MoveSettings{}, 0x5eed);
+    const InputAction script[] = {
+        InputAction::Hold,      InputAction::Left,     InputAction::Left,  InputAction::HardDrop,
+        InputAction::RotateCW,  InputAction::Right,    InputAction::Right, InputAction::HardDrop,
+        InputAction::RotateCCW, InputAction::HardDrop, InputAction::Right, InputAction::HardDrop,
+        InputAction::Rotate180, InputAction::Left,     InputAction::HardDrop,
+        InputAction::Hold,      InputAction::RotateCW,
+    };
+    std::int64_t t = 0;
+    for (InputAction a : script) {
+        t += 50'000;
+        sim.advanceTo(t);
+        sim.apply({a, true, t, 0});
+        sim.apply({a, false, t, 0});
+    }
+    const GameState& live = sim.state();
+    check(live.piecesPlaced == 5 && live.hasHold && !live.gameOver, "state: mid-run");
+
+    FumenPage page;
+    stateToFumen(live, page);
+    std::string text;
+    encodeFumen(std::span(&page, 1), text);
+    std::vector<FumenPage> pages;
+    check(decodeFumen(text, pages) && pages.size() == 1, "state: decodes");
+
+    GameState s;
+    s.bag = SevenBag(1);
+    spawn(s);
+    check(fumenToState(pages[0], s), "state: fits");
+    check(s.grid == live.grid, "state: grid");
+    check(s.active.type == live.active.type && s.active.rot == live.active.rot
+          && s.active.x == live.active.x && s.active.y == live.active.y, "state: active piece");
+    check(s.hasHold && s.holdType == live.holdType, "state: hold");
+    bool queue = true;
+    for (int i = 0; i < kFumenQuizPreview; ++i)
+        queue = queue && s.bag.peek(static_cast<std::size_t>(i)) == live.bag.peek(static_cast<std::size_t>(i));
+    check(queue, "state: queue");
+}
+
+int main() {
+    emptyPage();
+    quizPage();
+    mirrorRisePage();
+    stateRoundTrip();
+    if (g_failures)
+        std::fprintf(stderr, "%d check(s) failed\n", g_failures);
+    return g_failures == 0 ? 0 : 1;
+}
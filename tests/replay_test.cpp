@@ -0,0 +1,210 @@
+// tests/replay_test.cpp -- record a seeded run, play it back, no window
+#include "game/Logic.hpp"
+#include "game/Replay.hpp"
+#include "game/Simulation.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <map>
+#include <random>
+#include <vector>
+
+using namespace Tetris;
+
+static int g_failures = 0;
+
+static void check(bool ok, const char* what) {
+    if (!ok) {
+        std::fprintf(stderr, "FAIL: %s\n", what);
+        ++g_failures;
+    }
+}
+
+// everything playback has to reproduce
+struct Snap {
+    std::int64_t timeUs = 0;
+    GameState    state;
+};
+
+static Snap snap(const Simulation& sim) { return {sim.timeUs(), sim.state()}; }
+
+static bool same(const Snap& a, const Snap& b) {
+    const GameState& x = a.state;
+    const GameState& y = b.state;
+    const auto bx = x.bag.save();
+    const auto by = y.bag.save();
+    return a.timeUs == b.timeUs && x.grid == y.grid
+        && x.active.type == y.active.type && x.active.rot == y.active.rot
+        && x.active.x == y.active.x && x.active.y == y.active.y
+        && x.fallAccUs == y.fallAccUs && x.lockTimerUs == y.lockTimerUs && x.lockResets == y.lockResets
+        && x.hasHold == y.hasHold && x.holdType == y.holdType && x.canHold == y.canHold
+        && x.piecesPlaced == y.piecesPlaced && x.totalLinesCleared == y.totalLinesCleared
+        && x.level == y.level && x.gameOver == y.gameOver
+        && bx.rng == by.rng && bx.bag == by.bag && bx.nextBag == by.nextBag && bx.pos == by.pos;
+}
+
+// Flat, low stacks after placing the active piece at (rot, x); holes weigh
+// most. -1: it doesn't fit there.
+static int placementCost(const GameState& s, int rot, int x) {
+    GameState c = s;
+    c.active.rot = rot;
+    c.active.x   = x;
+    if (blocked(c, c.active))
+        return -1;
+    c.active = dropToGround(c);
+    lockPiece(c);
+    clearLines(c);
+    int cost = 0, last = -1;
+    for (int col = 0; col < COLS; ++col) {
+        int height = 0;
+        for (int row = ROWS - 1; row >= 0; --row) {
+            if (c.grid[row * COLS + col] != 0) {
+                if (height == 0)
+                    height = row + 1;
+            } else if (height != 0) {
+                cost += 30; // hole
+            }
+        }
+        cost += 2 * height + (last < 0 ? 0 : 3 * std::abs(height - last));
+        last = height;
+    }
+    return cost;
+}
+
+struct Recording {
+    std::vector<std::uint8_t> bytes;
+    std::map<int, Snap>       atPiece; // first step boundary with >= n pieces placed
+    Snap                      end;
+};
+
+// A seeded Endless run driven like SimulationThread drives the game:
+// inputs arrive between 1 ms steps, a keyframe is offered after every step.
+// A crude bot keeps the stack low; some pieces go through hold and every
+// seventh locks under gravity with soft drop held instead of a hard drop.
+static Recording record(int pieces) {
+    Recording out;
+    MoveSettings settings;
+    Simulation   sim;
+    ReplayRecorder rec;
+    const ReplayHeader header{RunType::Endless, settings, 0xC0FFEE, 0};
+    sim.reset(header.runType, header.settings, header.seed);
+    rec.begin(header);
+
+    std::mt19937 rng(41);
+    std::deque<InputEvent> queue;
+    std::uint32_t seq = 0;
+    auto press = [&](InputAction a, std::int64_t atUs, bool release) {
+        queue.push_back({a, true, atUs, ++seq});
+        if (release)
+            queue.push_back({a, false, atUs + 1 + static_cast<std::int64_t>(rng() % 1500), ++seq});
+    };
+
+    int  planned = -1;          // piecesPlaced the current target is for
+    int  targetRot = 0, targetX = 0, actions = 0;
+    bool softDropping = false;
+    out.atPiece[0] = snap(sim);
+    for (std::int64_t t = Simulation::kStepUs; t < 600'000'000; t += Simulation::kStepUs) {
+        while (!queue.empty() && queue.front().timeUs <= t) {
+            const InputEvent ev = queue.front();
+            queue.pop_front();
+            sim.advanceTo(ev.timeUs);
+            if (!sim.state().gameOver)
+                rec.record(ev);
+            sim.apply(ev);
+        }
+        sim.advanceTo(t);
+
+        const GameState& s = sim.state();
+        for (int n = out.atPiece.rbegin()->first + 1; n <= s.piecesPlaced; ++n)
+            out.atPiece[n] = snap(sim);
+        if (s.gameOver || s.piecesPlaced >= pieces)
+            break;
+        rec.keyframeIfDue(sim);
+        if (rec.pending() >= 1024) { // handed out in chunks, as to ReplayWriter
+            const auto chunk = rec.takeChunk();
+            out.bytes.insert(out.bytes.end(), chunk.begin(), chunk.end());
+        }
+
+        if (!queue.empty() || t % 4000 != 0)
+            continue; // one action every few ms
+        const std::int64_t at = t + static_cast<std::int64_t>(rng() % 1000);
+        if (softDropping) {
+            if (planned != s.piecesPlaced) {
+                press(InputAction::SoftDrop, at, false);
+                queue.back().pressed = false;
+                softDropping = false;
+            }
+            continue;
+        }
+        if (planned != s.piecesPlaced) {
+            if (s.canHold && s.piecesPlaced % 11 == 5) {
+                press(InputAction::Hold, at, true);
+                continue;
+            }
+            planned = s.piecesPlaced;
+            actions = 0;
+            int best = -1;
+            for (int rot = 0; rot < 4; ++rot)
+                for (int x = -2; x < COLS + 2; ++x) {
+                    const int cost = placementCost(s, rot, x);
+                    if (cost >= 0 && (best < 0 || cost < best)) {
+                        best = cost;
+                        targetRot = rot;
+                        targetX = x;
+                    }
+                }
+        }
+        if (++actions < 12 && s.active.rot != targetRot)
+            press(InputAction::RotateCW, at, true);
+        else if (actions < 12 && s.active.x != targetX)
+            press(s.active.x < targetX ? InputAction::Right : InputAction::Left, at, true);
+        else if (s.piecesPlaced % 7 == 3) {
+            press(InputAction::SoftDrop, at, false);
+            softDropping = true;
+        } else
+            press(InputAction::HardDrop, at, true);
+    }
+
+    const GameState& s = sim.state();
+    rec.end({sim.timeUs(), static_cast<std::uint32_t>(s.totalLinesCleared),
+             static_cast<std::uint32_t>(s.piecesPlaced), s.sprintTimeUs, s.gameOver});
+    const auto tail = rec.takeChunk();
+    out.bytes.insert(out.bytes.end(), tail.begin(), tail.end());
+    out.end = snap(sim);
+    return out;
+}
+
+int main() {
+    const Recording run = record(130);
+    check(run.end.state.piecesPlaced == 130 && !run.end.state.gameOver, "recorded run reaches 130 pieces");
+    check(run.end.state.totalLinesCleared > 0 && run.end.state.hasHold, "recorded run clears lines and holds");
+
+    ReplayPlayer player;
+    check(player.open(run.bytes), "opens");
+    check(player.decoder().keyframes().size() >= 2, "has keyframes");
+
+    player.runToEnd();
+    check(player.decoder().finished() && !player.decoder().error(), "runToEnd: reads to the end record");
+    check(same(snap(player.sim()), run.end), "runToEnd: same final state");
+
+    // backwards, across keyframes, forwards within one, and back to the start
+    for (int n : {130, 1, 49, 50, 51, 100, 77, 78, 101, 129, 0, 64}) {
+        player.seekToPiece(n);
+        if (!same(snap(player.sim()), run.atPiece.at(n))) {
+            std::fprintf(stderr, "FAIL: seekToPiece(%d)\n", n);
+            ++g_failures;
+        }
+    }
+
+    // a copy cut short (no end record, no index) still plays what it has
+    ReplayPlayer truncated;
+    const std::vector<std::uint8_t> half(run.bytes.begin(), run.bytes.begin() + static_cast<std::ptrdiff_t>(run.bytes.size() / 2));
+    check(truncated.open(half) && truncated.decoder().keyframes().empty(), "truncated: opens without an index");
+    truncated.runToEnd();
+    check(!truncated.decoder().finished(), "truncated: not finished");
+
+    if (g_failures)
+        std::fprintf(stderr, "%d check(s) failed\n", g_failures);
+    return g_failures == 0 ? 0 : 1;
+}
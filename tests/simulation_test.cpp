@@ -0,0 +1,84 @@
+// tests/simulation_test.cpp -- lock delay edge cases, no window
+#include "game/Gravity.hpp"
+#include "game/Simulation.hpp"
+
+#include <cstdio>
+
+using namespace Tetris;
+
+static int g_failures = 0;
+
+static void check(bool ok, const char* what, const char* where) {
+    if (!ok) {
+        std::fprintf(stderr, "FAIL: %s: %s\n", where, what);
+        ++g_failures;
+    }
+}
+
+static void tap(Simulation& sim, InputAction a) {
+    const std::int64_t t = sim.timeUs() + 5'000;
+    sim.advanceTo(t);
+    sim.apply({a, true, t, 0});
+    sim.apply({a, false, t, 0});
+}
+
+// An O rests on a ledge (columns 0-5, 10 rows high) with every lock reset
+// used up, then is moved off it. With the piece kept on the ground (20G or
+// instant soft drop) it drops straight to the floor, and that landing must
+// be fresh -- lock timer and resets back to 0 -- as under normal gravity.
+static void slideOffLedge(const char* where, MoveSettings settings, int level, bool holdSoftDrop) {
+    Simulation sim;
+    sim.reset(RunType::Endless, settings, 1);
+
+    Simulation::Checkpoint cp = sim.checkpoint();
+    GameState& s = cp.state;
+    s.grid = {};
+    for (int y = 0; y < 10; ++y)
+        for (int x = 0; x < 6; ++x)
+            s.grid[y * COLS + x] = cellValue(Tetromino::I);
+    s.active        = ActivePiece{Tetromino::O, 2, 15, 0};
+    s.level         = level;
+    s.rowIntervalUs = rowIntervalUsForLevel(level);
+    s.grounded      = false;
+    s.lockTimerUs   = 0;
+    s.lockResets    = 0;
+    sim.restore(cp);
+
+    if (holdSoftDrop) {
+        const std::int64_t t = sim.timeUs() + 1'000;
+        sim.advanceTo(t);
+        sim.apply({InputAction::SoftDrop, true, t, 0});
+    } else {
+        sim.advanceTo(sim.timeUs() + 1'000);
+    }
+    check(sim.state().active.y == 10 && sim.state().grounded, "rests on the ledge", where);
+
+    // use up the resets without leaving the ledge, then let the timer run
+    for (int i = 0; i < s.maxLockResets + 1; ++i)
+        tap(sim, i % 2 ? InputAction::Right : InputAction::Left);
+    sim.advanceTo(sim.timeUs() + 200'000);
+    check(sim.state().lockResets == s.maxLockResets && sim.state().lockTimerUs > 200'000,
+          "resets used up on the ledge", where);
+
+    while (sim.state().active.y == 10 && sim.state().active.x < 8)
+        tap(sim, InputAction::Right);
+    const GameState& after = sim.state();
+    check(after.active.y == 0 && after.grounded && after.piecesPlaced == 0, "dropped to the floor", where);
+    check(after.lockResets == 0 && after.lockTimerUs == 0, "lands with a fresh lock delay", where);
+
+    sim.advanceTo(sim.timeUs() + 5'000);
+    check(sim.state().lockTimerUs == 5'000 && sim.state().piecesPlaced == 0, "timer restarted", where);
+}
+
+int main() {
+    slideOffLedge("20G", MoveSettings{}, kMaxGravityLevel, false);
+    slideOffLedge("20G from level 19", MoveSettings{}, 19, false);
+
+    MoveSettings instantSdf;
+    instantSdf.sdf = kSdfInstant;
+    slideOffLedge("instant soft drop", instantSdf, 1, true);
+
+    if (g_failures)
+        std::fprintf(stderr, "%d check(s) failed\n", g_failures);
+    return g_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,187 @@
+// tools/bench_render.cpp
+// Offscreen render benchmark: replays fixed RenderSnapshots through
+// PlayfieldRenderer + Hud into an sf::RenderTexture (no window) and reports
+// CPU frame time (mean / p99) and the render counters of the last frame.
+// Always built with TETRIS_RENDER_STATS.
+//
+//   bench_render [--frames N] [--warmup N] [--size WxH] [--software]
+//
+// --software asks Mesa for its llvmpipe rasteriser so the numbers can be
+// collected on build machines without a GPU (needs a display or Xvfb).
+#include "core/ResourceCache.hpp"
+#include "game/GameState.hpp"
+#include "game/Logic.hpp"
+#include "game/Snapshot.hpp"
+#include "render/Colors.hpp"
+#include "render/Hud.hpp"
+#include "render/InstrumentedTarget.hpp"
+#include "render/PlayfieldRenderer.hpp"
+
+#include <SFML/Graphics/RenderTexture.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace Tetris;
+
+namespace {
+
+struct Scenario {
+    const char* name;
+    GameState   state;
+};
+
+// Fill rows [0, rows) leaving one hole per row so nothing would clear.
+void fillStack(GameState& s, int rows) {
+    for (int y = 0; y < rows; ++y) {
+        const int hole = (y * 3) % COLS;
+        for (int x = 0; x < COLS; ++x) {
+            if (x == hole) continue;
+            s.grid[y * COLS + x] = cellValue(static_cast<Tetromino>((x + y) % 7));
+        }
+    }
+}
+
+std::vector<Scenario> makeScenarios() {
+    std::vector<Scenario> out;
+
+    {
+        Scenario sc{"empty", {}};
+        spawn(sc.state);
+        out.push_back(std::move(sc));
+    }
+    {
+        Scenario sc{"half stack", {}};
+        fillStack(sc.state, VISIBLE_ROWS / 2);
+        spawn(sc.state);
+        out.push_back(std::move(sc));
+    }
+    {
+        // active piece sits inside the visible field so it and its ghost draw
+        Scenario sc{"full stack + ghost", {}};
+        fillStack(sc.state, VISIBLE_ROWS - 4);
+        spawnActive(sc.state, Tetromino::T);
+        sc.state.active.y = VISIBLE_ROWS - 2;
+        out.push_back(std::move(sc));
+    }
+    {
+        Scenario sc{"hold + queue (sprint)", {}};
+        fillStack(sc.state, VISIBLE_ROWS / 2);
+        spawn(sc.state);
+        sc.state.hasHold           = true;
+        sc.state.holdType          = Tetromino::I;
+        sc.state.runType           = RunType::Sprint;
+        sc.state.totalLinesCleared = 17;
+        sc.state.sprintTimeUs      = 23'450'000;
+        out.push_back(std::move(sc));
+    }
+    return out;
+}
+
+double percentile(std::vector<double> v, double p) {
+    if (v.empty()) return 0.0;
+    std::sort(v.begin(), v.end());
+    const auto idx = static_cast<std::size_t>(p * static_cast<double>(v.size() - 1) + 0.5);
+    return v[std::min(idx, v.size() - 1)];
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int frames = 2000;
+    int warmup = 200;
+    unsigned width = 1920, height = 1080;
+    bool software = false;
+
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--frames") && i + 1 < argc) {
+            frames = std::max(1, std::atoi(argv[++i]));
+        } else if (!std::strcmp(argv[i], "--warmup") && i + 1 < argc) {
+            warmup = std::max(0, std::atoi(argv[++i]));
+        } else if (!std::strcmp(argv[i], "--size") && i + 1 < argc) {
+            if (std::sscanf(argv[++i], "%ux%u", &width, &height) != 2 || width == 0 || height == 0) {
+                std::fprintf(stderr, "bench_render: --size expects WxH\n");
+                return 2;
+            }
+        } else if (!std::strcmp(argv[i], "--software")) {
+            software = true;
+        } else {
+            std::fprintf(stderr, "usage: bench_render [--frames N] [--warmup N] [--size WxH] [--software]\n");
+            return 2;
+        }
+    }
+
+    if (software) {
+#ifndef _WIN32
+        // must happen before SFML creates its first GL context
+        setenv("LIBGL_ALWAYS_SOFTWARE", "1", 0);
+        setenv("GALLIUM_DRIVER", "llvmpipe", 0);
+#else
+        std::fprintf(stderr, "bench_render: --software is ignored on Windows\n");
+#endif
+    }
+
+    sf::RenderTexture rt;
+    if (!rt.resize({width, height})) {
+        std::fprintf(stderr, "bench_render: could not create a %ux%u render texture\n", width, height);
+        return 1;
+    }
+
+    InstrumentedTarget target(rt);
+    PlayfieldRenderer  playfield(target);
+    Hud                hud(target);
+
+    ResourceCache resources;
+    const auto font = resources.font("fonts/DejaVuSans.ttf");
+    if (font)
+        hud.setFont(*font);
+    else
+        std::fprintf(stderr, "bench_render: font missing, HUD text is not measured\n");
+
+    std::printf("bench_render: %ux%u, %d frames (+%d warmup) per scenario\n\n",
+                width, height, frames, warmup);
+    std::printf("%-24s %10s %10s %10s %8s %10s %7s %7s\n",
+                "scenario", "mean ms", "p99 ms", "max ms", "draws", "vertices", "binds", "texts");
+
+    using clock = std::chrono::steady_clock;
+    constexpr float kFrameDt = 1.f / 240.f;
+
+    for (const auto& sc : makeScenarios()) {
+        std::vector<double> times;
+        times.reserve(static_cast<std::size_t>(frames));
+        RenderCounters last{};
+        const RenderSnapshot snap = makeSnapshot(sc.state);
+
+        for (int f = 0; f < warmup + frames; ++f) {
+            target.beginFrame();
+            const auto t0 = clock::now();
+
+            rt.clear(Colors::Bg);
+            playfield.draw(snap);
+            target.setView(target.getDefaultView());
+            hud.update(kFrameDt);
+            hud.draw(snap);
+            rt.display();
+
+            const auto t1 = clock::now();
+            if (f >= warmup)
+                times.push_back(std::chrono::duration<double, std::milli>(t1 - t0).count());
+            last = target.stats().total();
+        }
+
+        double mean = 0.0;
+        for (double t : times) mean += t;
+        mean /= static_cast<double>(times.size());
+
+        std::printf("%-24s %10.4f %10.4f %10.4f %8u %10u %7u %7u\n",
+                    sc.name, mean, percentile(times, 0.99),
+                    *std::max_element(times.begin(), times.end()),
+                    last.drawCalls, last.vertices, last.textureBinds, last.textRebuilds);
+    }
+    return 0;
+}
@@ -0,0 +1,371 @@
+// tools/fumen_bulk.cpp
+// Converts large fumen collections (training-puzzle sets) to and from a
+// fixed-size binary form, on every core.
+//
+//   fumen_bulk decode [--threads N] <in.txt> <out.tsfb | ->
+//   fumen_bulk encode [--threads N] <in.tsfb> <out.txt | ->
+//
+// decode: one fumen per line (blank lines skipped, links fine); every page
+// becomes one 144-byte record tagged with its line and page number. Lines
+// that don't decode are counted and reported, not fatal. encode: records
+// sharing a line number become one multi-page fumen per output line again.
+//
+// The input is memory-mapped and cut into ~1 MB pieces on line / record
+// boundaries, converted in parallel and written in input order by a single
+// writer thread; a bounded number of pieces are in flight, so memory stays
+// flat for any input size and the disk or the decoder, not coordination,
+// sets the pace.
+//
+// Layout (host order, little-endian only):
+//   header (16 bytes)  magic "TSRSFMN\0", u32 version, u32 record size
+//   records (144 bytes each, FumenRecord below): the page's field as
+//   nibbles in fumen order, its piece and flags, and the quiz's hold /
+//   current / first 16 queue pieces. Comments other than a quiz are not
+//   kept (flag kLossy marks pages that lost one).
+#include "core/MappedFile.hpp"
+#include "core/ThreadPool.hpp"
+#include "game/Fumen.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <future>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+using namespace Tetris;
+namespace fs = std::filesystem;
+
+static_assert(std::endian::native == std::endian::little, "records are written in host order");
+
+static constexpr char          kMagic[8]    = {'T', 'S', 'R', 'S', 'F', 'M', 'N', '\0'};
+static constexpr std::uint32_t kVersion     = 1;
+static constexpr std::size_t   kChunkBytes  = std::size_t{1} << 20;
+static constexpr int           kQueueKept   = 16;
+
+enum : std::uint8_t {
+    kLock     = 1 << 0,
+    kRise     = 1 << 1,
+    kMirror   = 1 << 2,
+    kColorize = 1 << 3,
+    kQuiz     = 1 << 4, // hold / current / queue are valid
+    kLossy    = 1 << 5, // the comment (or a long quiz queue) didn't fit
+};
+
+struct FileHeader {
+    char          magic[8];
+    std::uint32_t version;
+    std::uint32_t recordSize;
+};
+struct FumenRecord {
+    std::uint32_t line;       // 1-based line of the source text
+    std::uint16_t page;       // 0-based page within it
+    std::uint8_t  piece;      // FumenPiece
+    std::uint8_t  rotation;   // ActivePiece::rot order
+    std::int8_t   x, y;       // FumenPage::x / y
+    std::uint8_t  flags;
+    std::uint8_t  hold, current, queueLen;
+    std::uint8_t  pad[2];
+    std::uint8_t  queue[kQueueKept / 2];  // two pieces per byte, low nibble first
+    std::uint8_t  field[kFumenCells / 2]; // likewise, fumen order (top row first)
+};
+static_assert(sizeof(FileHeader) == 16 && sizeof(FumenRecord) == 144);
+
+namespace {
+
+struct Chunk {
+    std::vector<std::uint8_t> bytes;
+    std::uint32_t lines    = 0;  // decode: lines consumed
+    std::uint64_t pages    = 0;
+    std::uint32_t bad      = 0;  // lines that weren't a fumen
+    std::uint32_t firstBad = 0;  // chunk-local line of the first one
+};
+
+void packRecord(const FumenPage& p, std::uint32_t line, std::uint16_t page, FumenRecord& r) {
+    std::memset(&r, 0, sizeof(r));
+    r.line     = line;
+    r.page     = page;
+    r.piece    = static_cast<std::uint8_t>(p.piece);
+    r.rotation = p.rotation;
+    r.x        = p.x;
+    r.y        = p.y;
+    r.flags    = static_cast<std::uint8_t>((p.lock ? kLock : 0) | (p.rise ? kRise : 0)
+                                           | (p.mirror ? kMirror : 0) | (p.colorize ? kColorize : 0));
+    if (!p.comment.empty()) {
+        FumenQuiz q;
+        if (parseFumenQuiz(p.comment, q)) {
+            r.flags  |= kQuiz;
+            r.hold    = static_cast<std::uint8_t>(q.hold);
+            r.current = static_cast<std::uint8_t>(q.current);
+            r.queueLen = static_cast<std::uint8_t>(std::min(q.count, kQueueKept));
+            for (int i = 0; i < r.queueLen; ++i)
+                r.queue[i / 2] |= static_cast<std::uint8_t>(static_cast<int>(q.next[static_cast<std::size_t>(i)]) << (i % 2 * 4));
+            // anything beyond a plain quiz (trailing text, a longer queue) is lost
+            thread_local std::string formatted;
+            formatFumenQuiz(q, formatted);
+            if (q.count > kQueueKept || formatted != p.comment)
+                r.flags |= kLossy;
+        } else {
+            r.flags |= kLossy;
+        }
+    }
+    for (int i = 0; i < kFumenCells; i += 2)
+        r.field[i / 2] = static_cast<std::uint8_t>(static_cast<int>(p.field[static_cast<std::size_t>(i)])
+                                                   | static_cast<int>(p.field[static_cast<std::size_t>(i + 1)]) << 4);
+}
+
+void unpackRecord(const FumenRecord& r, FumenPage& p) {
+    const auto piece = [](int v) { return static_cast<FumenPiece>(std::min(v, static_cast<int>(FumenPiece::Gray))); };
+    for (int i = 0; i < kFumenCells; i += 2) {
+        p.field[static_cast<std::size_t>(i)]     = piece(r.field[i / 2] & 0xF);
+        p.field[static_cast<std::size_t>(i + 1)] = piece(r.field[i / 2] >> 4);
+    }
+    p.piece    = piece(r.piece);
+    p.rotation = r.rotation & 3;
+    p.x        = r.x;
+    p.y        = r.y;
+    p.lock     = r.flags & kLock;
+    p.rise     = r.flags & kRise;
+    p.mirror   = r.flags & kMirror;
+    p.colorize = r.flags & kColorize;
+    if (r.flags & kQuiz) {
+        FumenQuiz q;
+        q.hold    = piece(r.hold);
+        q.current = piece(r.current);
+        q.count   = std::min<int>(r.queueLen, kQueueKept);
+        for (int i = 0; i < q.count; ++i)
+            q.next[static_cast<std::size_t>(i)] = piece(r.queue[i / 2] >> (i % 2 * 4) & 0xF);
+        formatFumenQuiz(q, p.comment);
+    } else {
+        p.comment.clear();
+    }
+}
+
+Chunk decodeChunk(std::string_view text) {
+    thread_local std::vector<FumenPage> pages; // reused across chunks: no allocation per fumen
+    Chunk c;
+    c.bytes.reserve(text.size() * 4);
+    for (std::size_t pos = 0; pos < text.size();) {
+        std::size_t end = text.find('\n', pos);
+        if (end == std::string_view::npos)
+            end = text.size();
+        std::string_view line = text.substr(pos, end - pos);
+        pos = end + 1;
+        ++c.lines;
+
+        while (!line.empty() && (line.back() == '\r' || line.back() == ' ' || line.back() == '\t'))
+            line.remove_suffix(1);
+        if (line.empty())
+            continue;
+        if (!decodeFumen(line, pages) || pages.size() > 0xFFFF) {
+            if (c.bad++ == 0)
+                c.firstBad = c.lines;
+            continue;
+        }
+        const std::size_t at = c.bytes.size();
+        c.bytes.resize(at + pages.size() * sizeof(FumenRecord));
+        for (std::size_t i = 0; i < pages.size(); ++i) {
+            FumenRecord r;
+            packRecord(pages[i], c.lines, static_cast<std::uint16_t>(i), r);
+            std::memcpy(c.bytes.data() + at + i * sizeof(FumenRecord), &r, sizeof(r));
+        }
+        c.pages += pages.size();
+    }
+    return c;
+}
+
+Chunk encodeChunk(const std::uint8_t* data, std::size_t count) {
+    thread_local std::vector<FumenPage> pages;
+    thread_local std::string fumen;
+    Chunk c;
+    c.bytes.reserve(count * 48);
+    for (std::size_t i = 0; i < count;) {
+        FumenRecord first;
+        std::memcpy(&first, data + i * sizeof(FumenRecord), sizeof(first));
+        std::size_t n = 0;
+        for (FumenRecord r = first; i < count; ++i, ++n) {
+            std::memcpy(&r, data + i * sizeof(FumenRecord), sizeof(r));
+            if (r.line != first.line)
+                break;
+            if (n == pages.size())
+                pages.emplace_back();
+            unpackRecord(r, pages[n]);
+        }
+        fumen.clear();
+        encodeFumen({pages.data(), n}, fumen);
+        fumen += '\n';
+        c.bytes.insert(c.bytes.end(), fumen.begin(), fumen.end());
+        c.pages += n;
+        ++c.lines;
+    }
+    return c;
+}
+
+int usage() {
+    std::fprintf(stderr, "usage: fumen_bulk decode [--threads N] <in.txt> <out.tsfb | ->\n"
+                         "       fumen_bulk encode [--threads N] <in.tsfb> <out.txt | ->\n");
+    return 2;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2)
+        return usage();
+    const std::string_view command = argv[1];
+    const bool decoding = command == "decode";
+    if (!decoding && command != "encode")
+        return usage();
+
+    unsigned threads = ThreadPool::defaultThreadCount();
+    fs::path input, outPath;
+    for (int i = 2; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--threads") && i + 1 < argc)
+            threads = static_cast<unsigned>(std::max(1, std::atoi(argv[++i])));
+        else if (input.empty())
+            input = argv[i];
+        else if (outPath.empty())
+            outPath = argv[i];
+        else
+            return usage();
+    }
+    if (input.empty() || outPath.empty())
+        return usage();
+
+    MappedFile file;
+    if (!file.open(input)) {
+        std::fprintf(stderr, "fumen_bulk: could not open '%s'\n", input.string().c_str());
+        return 1;
+    }
+    const std::uint8_t* data = file.data();
+    std::size_t         size = file.size();
+    if (!decoding) {
+        FileHeader h{};
+        if (size < sizeof(h) || (std::memcpy(&h, data, sizeof(h)), std::memcmp(h.magic, kMagic, 8) != 0)
+            || h.version != kVersion || h.recordSize != sizeof(FumenRecord)
+            || (size - sizeof(h)) % sizeof(FumenRecord) != 0) {
+            std::fprintf(stderr, "fumen_bulk: '%s' is not a fumen record file\n", input.string().c_str());
+            return 1;
+        }
+        data += sizeof(h);
+        size -= sizeof(h);
+    }
+
+    const bool toStdout = outPath == "-";
+#ifdef _WIN32
+    if (toStdout) // records are binary, and fumen lines stay LF like the files
+        _setmode(_fileno(stdout), _O_BINARY);
+#endif
+    std::FILE* out = toStdout ? stdout : std::fopen(outPath.string().c_str(), "wb");
+    if (!out) {
+        std::fprintf(stderr, "fumen_bulk: could not create '%s'\n", outPath.string().c_str());
+        return 1;
+    }
+    bool ok = true;
+    if (decoding) {
+        FileHeader h{};
+        std::memcpy(h.magic, kMagic, 8);
+        h.version    = kVersion;
+        h.recordSize = sizeof(FumenRecord);
+        ok = std::fwrite(&h, sizeof(h), 1, out) == 1;
+    }
+
+    const auto t0 = std::chrono::steady_clock::now();
+    std::uint64_t lines = 0, pages = 0, bad = 0;
+    std::uint32_t firstBad = 0; // file line of the first line that wasn't a fumen
+    {
+        ThreadPool workers(threads);
+        ThreadPool writer(1);
+        const std::size_t maxInFlight = workers.size() * 2;
+        std::deque<std::future<bool>> inFlight;
+
+        // Runs on the writer thread in input order, so that's where chunk-local
+        // line numbers become file line numbers.
+        std::uint32_t lineBase = 0;
+        const auto write = [&, out](std::future<Chunk> pending) {
+            inFlight.push_back(writer.submit([&, out, pending = std::move(pending)]() mutable {
+                Chunk c = pending.get();
+                if (decoding) {
+                    for (std::size_t at = 0; at < c.bytes.size(); at += sizeof(FumenRecord)) {
+                        std::uint32_t line;
+                        std::memcpy(&line, c.bytes.data() + at, 4);
+                        line += lineBase;
+                        std::memcpy(c.bytes.data() + at, &line, 4);
+                    }
+                    if (c.bad && bad == 0)
+                        firstBad = lineBase + c.firstBad;
+                }
+                lineBase += c.lines;
+                lines += c.lines;
+                pages += c.pages;
+                bad   += c.bad;
+                return std::fwrite(c.bytes.data(), 1, c.bytes.size(), out) == c.bytes.size();
+            }));
+            while (inFlight.size() > maxInFlight) {
+                ok = inFlight.front().get() && ok;
+                inFlight.pop_front();
+            }
+        };
+
+        if (decoding) {
+            const std::string_view text(reinterpret_cast<const char*>(data), size);
+            for (std::size_t pos = 0; pos < text.size() && ok;) {
+                std::size_t end = std::min(pos + kChunkBytes, text.size());
+                if (end < text.size()) {
+                    const std::size_t nl = text.find('\n', end);
+                    end = nl == std::string_view::npos ? text.size() : nl + 1;
+                }
+                write(workers.submit([piece = text.substr(pos, end - pos)] { return decodeChunk(piece); }));
+                pos = end;
+            }
+        } else {
+            // never split the pages of one fumen across chunks
+            const std::size_t count = size / sizeof(FumenRecord);
+            const std::size_t step  = kChunkBytes / sizeof(FumenRecord);
+            const auto lineOf = [data](std::size_t i) {
+                std::uint32_t line;
+                std::memcpy(&line, data + i * sizeof(FumenRecord), 4);
+                return line;
+            };
+            for (std::size_t i = 0; i < count && ok;) {
+                std::size_t end = std::min(i + step, count);
+                while (end < count && lineOf(end) == lineOf(end - 1))
+                    ++end;
+                write(workers.submit([first = data + i * sizeof(FumenRecord), n = end - i] {
+                    return encodeChunk(first, n);
+                }));
+                i = end;
+            }
+        }
+        while (!inFlight.empty()) {
+            ok = inFlight.front().get() && ok;
+            inFlight.pop_front();
+        }
+    }
+    ok = (toStdout ? std::fflush(out) == 0 : std::fclose(out) == 0) && ok;
+    if (!ok) {
+        std::fprintf(stderr, "fumen_bulk: writing '%s' failed\n", outPath.string().c_str());
+        return 1;
+    }
+
+    if (bad)
+        std::fprintf(stderr, "fumen_bulk: %llu line(s) not a fumen, the first is line %u\n",
+                     static_cast<unsigned long long>(bad), firstBad);
+    const double wallS = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    std::fprintf(stderr, "fumen_bulk: %s %llu page(s) on %llu line(s), %llu skipped, in %.2f s (%.0f MB/s in, %u threads)\n",
+                 decoding ? "decoded" : "encoded", static_cast<unsigned long long>(pages),
+                 static_cast<unsigned long long>(lines), static_cast<unsigned long long>(bad), wallS,
+                 wallS > 0.0 ? static_cast<double>(size) / wallS / 1e6 : 0.0, threads);
+    return 0;
+}
@@ -0,0 +1,778 @@
+// tools/position_db.cpp
+// Database of every distinct board reached across a corpus of replays.
+//
+//   position_db build [--threads N] [--mem MB] <out.tspd> <replay.tsrr | directory>...
+//   position_db info   <db.tspd>
+//   position_db games  <db.tspd> (--at replay.tsrr:PIECE | --board file.txt) [--limit N]
+//   position_db common <db.tspd> --piece N [--top K]
+//
+// A position is the locked stack right after a piece is placed (cell
+// occupancy only, colours ignored). Each one is keyed by a 128-bit hash of
+// the board and stored once with its occurrence count and every (game,
+// piece) that reached it, so "which games reached this board" is a binary
+// search and "most common positions after piece 14" reads the head of a
+// presorted list. The file is memory-mapped for queries; nothing is loaded.
+//
+// Building scales past memory: occurrences are sorted in runs of --mem MB
+// spilled next to the output and merged, so hundreds of millions of
+// positions need disk, not RAM. Replays are decoded in parallel; game ids
+// follow input order.
+//
+// Layout (host order, little-endian only), sections 8-byte aligned:
+//   header (128 bytes)  magic "TSRSPDB\0", u32 version, u32 maxPiece,
+//                       u64 games, positions, occurrences, pieceRows,
+//                       u64 offsets of the sections below
+//   games        24 B   u64 seed, u64 name offset, u32 name length, u8 run
+//   names               replay paths, as given to build
+//   occurrences   8 B   u32 game, u32 piece; grouped by position
+//   positions    32 B   u64 hash hi, u64 hash lo, u64 first occurrence,
+//                       u32 occurrences, u32 distinct games; sorted by hash
+//   piece rows    8 B   u32 position, u32 count; by piece, then count desc
+//   piece dir           (maxPiece + 2) x u64: rows of piece p are
+//                       dir[p] .. dir[p + 1]
+#include "core/MappedFile.hpp"
+#include "core/ThreadPool.hpp"
+#include "game/Replay.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <queue>
+#include <string>
+#include <system_error>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+using namespace Tetris;
+namespace fs = std::filesystem;
+
+static_assert(std::endian::native == std::endian::little, "the database is written in host order");
+
+static constexpr char          kDbMagic[8] = {'T', 'S', 'R', 'S', 'P', 'D', 'B', '\0'};
+static constexpr std::uint32_t kDbVersion  = 1;
+
+struct DbHeader {
+    char          magic[8];
+    std::uint32_t version;
+    std::uint32_t maxPiece;
+    std::uint64_t games, positions, occurrences, pieceRows;
+    std::uint64_t gamesOff, namesOff, occOff, posOff, rowsOff, dirOff;
+    std::uint8_t  reserved[32];
+};
+struct DbGame {
+    std::uint64_t seed;
+    std::uint64_t name;
+    std::uint32_t nameLen;
+    std::uint8_t  run;
+    std::uint8_t  pad[3];
+};
+struct DbOcc {
+    std::uint32_t game;
+    std::uint32_t piece;
+};
+struct DbPosition {
+    std::uint64_t hi, lo;
+    std::uint64_t firstOcc;
+    std::uint32_t count;
+    std::uint32_t games;
+};
+struct DbPieceRow {
+    std::uint32_t position;
+    std::uint32_t count;
+};
+static_assert(sizeof(DbHeader) == 128 && sizeof(DbGame) == 24 && sizeof(DbOcc) == 8
+              && sizeof(DbPosition) == 32 && sizeof(DbPieceRow) == 8);
+
+// ---- board hash -------------------------------------------------------------
+
+struct BoardHash {
+    std::uint64_t hi = 0, lo = 0;
+    auto operator<=>(const BoardHash&) const = default;
+};
+
+static std::uint64_t mix64(std::uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// Occupancy packed into 4 words, then two independently seeded lanes: at
+// 1e9 distinct boards a collision is ~1e-20 likely.
+using Board = std::array<std::uint64_t, 4>;
+
+static Board packBoard(const GameState& s) {
+    Board b{};
+    for (std::size_t i = 0; i < s.grid.size(); ++i)
+        if (s.grid[i] != 0)
+            b[i / 64] |= std::uint64_t{1} << (i % 64);
+    return b;
+}
+
+static BoardHash hashBoard(const Board& b) {
+    BoardHash h{0x9E3779B97F4A7C15ull, 0xD1B54A32D192ED03ull};
+    for (std::uint64_t w : b) {
+        h.hi = mix64(h.hi ^ mix64(w + 0x243F6A8885A308D3ull));
+        h.lo = mix64(h.lo ^ mix64(w ^ 0x13198A2E03707344ull) * 0xA4093822299F31D0ull);
+    }
+    return h;
+}
+
+static bool cell(const Board& b, int x, int y) {
+    const int i = y * COLS + x;
+    return (b[static_cast<std::size_t>(i / 64)] >> (i % 64)) & 1;
+}
+
+// row 0 is the floor; empty rows above the stack are left out
+static void printBoard(const Board& b) {
+    int top = ROWS - 1;
+    while (top > 0 && [&] { for (int x = 0; x < COLS; ++x) if (cell(b, x, top)) return false; return true; }())
+        --top;
+    for (int y = top; y >= 0; --y) {
+        char line[COLS + 1];
+        for (int x = 0; x < COLS; ++x)
+            line[x] = cell(b, x, y) ? '#' : '.';
+        line[COLS] = '\0';
+        std::printf("    %s\n", line);
+    }
+}
+
+// Board after `piece` pieces, through the replay's own keyframes.
+static bool boardAt(const fs::path& path, int piece, Board& out) {
+    MappedFile   file;
+    ReplayPlayer player;
+    if (!file.open(path) || !player.open({file.data(), file.size()}))
+        return false;
+    player.seekToPiece(piece);
+    if (player.sim().state().piecesPlaced != piece)
+        return false;
+    out = packBoard(player.sim().state());
+    return true;
+}
+
+// rows of '.' (empty) and anything else (filled), top to bottom; the last
+// row is the floor
+static bool readBoardFile(const fs::path& path, Board& out) {
+    std::ifstream in(path);
+    std::vector<std::string> rows;
+    std::string line;
+    while (std::getline(in, line)) {
+        while (!line.empty() && (line.back() == '\r' || line.back() == ' '))
+            line.pop_back();
+        if (!line.empty())
+            rows.push_back(line);
+    }
+    if (rows.empty() || rows.size() > static_cast<std::size_t>(ROWS))
+        return false;
+    out = {};
+    for (std::size_t r = 0; r < rows.size(); ++r) {
+        const std::string& row = rows[rows.size() - 1 - r]; // bottom up
+        if (row.size() != static_cast<std::size_t>(COLS))
+            return false;
+        for (int x = 0; x < COLS; ++x) {
+            const int i = static_cast<int>(r) * COLS + x;
+            if (row[static_cast<std::size_t>(x)] != '.')
+                out[static_cast<std::size_t>(i / 64)] |= std::uint64_t{1} << (i % 64);
+        }
+    }
+    return true;
+}
+
+// ---- external sort ----------------------------------------------------------
+
+// Sorts more records than fit in memory: full buffers are sorted and
+// written out as runs, merge() then streams the k-way merge of all runs.
+template<class T, class Less>
+class ExternalSorter {
+    static_assert(std::is_trivially_copyable_v<T>);
+
+public:
+    ExternalSorter(fs::path stem, std::size_t memBytes)
+        : m_stem(std::move(stem)), m_cap(std::max<std::size_t>(memBytes / sizeof(T), 1024)) {}
+
+    ~ExternalSorter() {
+        std::error_code ec;
+        for (const fs::path& p : m_runs)
+            fs::remove(p, ec);
+    }
+
+    bool add(const T& v) {
+        m_buf.push_back(v);
+        ++m_count;
+        return m_buf.size() < m_cap || spill();
+    }
+
+    std::uint64_t size() const { return m_count; }
+
+    // fn(const T&) for every record in order; false on an I/O error
+    template<class Fn>
+    bool merge(Fn&& fn) {
+        if (m_runs.empty()) {
+            std::sort(m_buf.begin(), m_buf.end(), Less{});
+            for (const T& v : m_buf)
+                fn(v);
+            return true;
+        }
+        if (!spill())
+            return false;
+        m_buf = {};
+
+        struct Run {
+            std::FILE*     f = nullptr;
+            std::vector<T> buf;
+            std::size_t    pos = 0;
+            bool refill() {
+                buf.resize(kRunBuffer);
+                buf.resize(std::fread(buf.data(), sizeof(T), kRunBuffer, f));
+                pos = 0;
+                return !buf.empty();
+            }
+        };
+        std::vector<Run> runs(m_runs.size());
+        for (std::size_t i = 0; i < runs.size(); ++i) {
+            runs[i].f = std::fopen(m_runs[i].string().c_str(), "rb");
+            if (!runs[i].f) {
+                for (Run& r : runs)
+                    if (r.f) std::fclose(r.f);
+                return false;
+            }
+        }
+
+        const auto later = [&](std::size_t a, std::size_t b) {
+            return Less{}(runs[b].buf[runs[b].pos], runs[a].buf[runs[a].pos]);
+        };
+        std::priority_queue<std::size_t, std::vector<std::size_t>, decltype(later)> heads(later);
+        for (std::size_t i = 0; i < runs.size(); ++i)
+            if (runs[i].refill())
+                heads.push(i);
+        while (!heads.empty()) {
+            const std::size_t i = heads.top();
+            heads.pop();
+            fn(runs[i].buf[runs[i].pos]);
+            if (++runs[i].pos < runs[i].buf.size() || runs[i].refill())
+                heads.push(i);
+        }
+        for (Run& r : runs)
+            std::fclose(r.f);
+        return true;
+    }
+
+private:
+    static constexpr std::size_t kRunBuffer = 1 << 16; // records read ahead per run
+
+    bool spill() {
+        if (m_buf.empty())
+            return true;
+        std::sort(m_buf.begin(), m_buf.end(), Less{});
+        fs::path path = m_stem;
+        path += ".run" + std::to_string(m_runs.size());
+        std::FILE* f = std::fopen(path.string().c_str(), "wb");
+        const bool ok = f && std::fwrite(m_buf.data(), sizeof(T), m_buf.size(), f) == m_buf.size();
+        if (f)
+            std::fclose(f);
+        m_runs.push_back(std::move(path));
+        m_buf.clear();
+        if (!ok)
+            std::fprintf(stderr, "[PosDB] could not write sort run '%s'\n", m_runs.back().string().c_str());
+        return ok;
+    }
+
+    fs::path              m_stem;
+    std::size_t           m_cap;
+    std::vector<T>        m_buf;
+    std::vector<fs::path> m_runs;
+    std::uint64_t         m_count = 0;
+};
+
+// ---- build ------------------------------------------------------------------
+
+struct Occurrence {
+    BoardHash     hash;
+    std::uint32_t game;
+    std::uint32_t piece;
+};
+struct OccurrenceLess {
+    bool operator()(const Occurrence& a, const Occurrence& b) const {
+        return std::tie(a.hash, a.game, a.piece) < std::tie(b.hash, b.game, b.piece);
+    }
+};
+
+struct PieceRow {
+    std::uint32_t piece, count, position;
+};
+struct PieceRowLess {
+    bool operator()(const PieceRow& a, const PieceRow& b) const {
+        return std::tie(a.piece, b.count, a.position) < std::tie(b.piece, a.count, b.position);
+    }
+};
+
+struct GameBoards {
+    bool          ok = false;
+    fs::path      path;
+    std::uint64_t seed = 0;
+    RunType       run  = RunType::Endless;
+    std::vector<BoardHash> boards; // boards[i]: after piece i + 1
+};
+
+// Every locked position of one replay, stepped like replay_stats so locks
+// by gravity are seen as well as hard drops.
+static GameBoards ingest(fs::path path) {
+    GameBoards g;
+    g.path = std::move(path);
+
+    MappedFile    file;
+    ReplayDecoder dec;
+    if (!file.open(g.path) || !dec.open({file.data(), file.size()}))
+        return g;
+    const ReplayHeader& h = dec.header();
+    g.seed = h.seed;
+    g.run  = h.runType;
+
+    Simulation sim;
+    sim.reset(h.runType, h.settings, h.seed);
+    const auto observe = [&] {
+        const GameState& s = sim.state();
+        if (static_cast<std::size_t>(s.piecesPlaced) > g.boards.size())
+            g.boards.push_back(hashBoard(packBoard(s)));
+    };
+    const auto runTo = [&](std::int64_t t) {
+        while (sim.timeUs() < t) {
+            sim.advanceTo(std::min(t, sim.timeUs() + Simulation::kStepUs));
+            observe();
+        }
+    };
+
+    InputEvent in;
+    while (dec.next(in)) {
+        runTo(in.timeUs);
+        sim.apply(in);
+        observe();
+    }
+    if (dec.error())
+        return g;
+    if (dec.finished())
+        runTo(dec.result().endTimeUs);
+    g.ok = true;
+    return g;
+}
+
+class DbWriter {
+public:
+    ~DbWriter() {
+        if (m_f)
+            std::fclose(m_f);
+    }
+
+    bool open(const fs::path& path) {
+        m_f = std::fopen(path.string().c_str(), "wb");
+        return m_f != nullptr;
+    }
+    std::uint64_t offset() const { return m_offset; }
+
+    void write(const void* p, std::size_t n) {
+        m_ok = m_ok && std::fwrite(p, 1, n, m_f) == n;
+        m_offset += n;
+    }
+    template<class T>
+    void put(const T& v) { write(&v, sizeof(T)); }
+    void align() {
+        static const char zeros[8] = {};
+        write(zeros, (8 - m_offset % 8) % 8);
+    }
+
+    bool finish(const DbHeader& header) {
+        m_ok = m_ok && std::fseek(m_f, 0, SEEK_SET) == 0 && std::fwrite(&header, sizeof(header), 1, m_f) == 1;
+        m_ok = std::fclose(m_f) == 0 && m_ok;
+        m_f = nullptr;
+        return m_ok;
+    }
+
+private:
+    std::FILE*    m_f = nullptr;
+    std::uint64_t m_offset = 0;
+    bool          m_ok = true;
+};
+
+static int build(int argc, char** argv) {
+    unsigned threads = ThreadPool::defaultThreadCount();
+    std::size_t memMb = 512;
+    fs::path out;
+    std::vector<fs::path> inputs;
+    for (int i = 0; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = static_cast<unsigned>(std::max(1, std::atoi(argv[++i])));
+        } else if (std::strcmp(argv[i], "--mem") == 0 && i + 1 < argc) {
+            memMb = static_cast<std::size_t>(std::max(16, std::atoi(argv[++i])));
+        } else if (argv[i][0] == '-') {
+            return 2;
+        } else if (out.empty()) {
+            out = argv[i];
+        } else {
+            inputs.emplace_back(argv[i]);
+        }
+    }
+    if (out.empty() || inputs.empty())
+        return 2;
+
+    const auto t0 = std::chrono::steady_clock::now();
+    DbWriter db;
+    if (!db.open(out)) {
+        std::fprintf(stderr, "[PosDB] could not create '%s'\n", out.string().c_str());
+        return 1;
+    }
+    DbHeader header{};
+    std::memcpy(header.magic, kDbMagic, sizeof(kDbMagic));
+    header.version = kDbVersion;
+    db.put(header); // placeholder, rewritten at the end
+
+    // 1. decode every replay; occurrences go to the external sort
+    ExternalSorter<Occurrence, OccurrenceLess> occurrences(out, memMb << 20);
+    std::vector<DbGame> games;
+    std::string         names;
+    std::size_t         failed = 0;
+    std::uint32_t       maxPiece = 0;
+    bool ok = true;
+    {
+        ThreadPool pool(threads);
+        const std::size_t maxInFlight = pool.size() * 4;
+        std::deque<std::future<GameBoards>> inFlight;
+
+        const auto drainOne = [&] {
+            GameBoards g = inFlight.front().get();
+            inFlight.pop_front();
+            if (!g.ok) {
+                ++failed;
+                std::fprintf(stderr, "[PosDB] %s: not a readable replay\n", g.path.string().c_str());
+                return;
+            }
+            const auto game = static_cast<std::uint32_t>(games.size());
+            const std::string name = g.path.string();
+            DbGame meta{};
+            meta.seed    = g.seed;
+            meta.name    = names.size();
+            meta.nameLen = static_cast<std::uint32_t>(name.size());
+            meta.run     = static_cast<std::uint8_t>(g.run);
+            games.push_back(meta);
+            names += name;
+            for (std::size_t i = 0; i < g.boards.size(); ++i)
+                ok = ok && occurrences.add({g.boards[i], game, static_cast<std::uint32_t>(i + 1)});
+            maxPiece = std::max(maxPiece, static_cast<std::uint32_t>(g.boards.size()));
+        };
+
+        for (const fs::path& in : inputs) {
+            std::error_code ec;
+            const auto submit = [&](fs::path p) {
+                if (inFlight.size() >= maxInFlight)
+                    drainOne();
+                inFlight.push_back(pool.submit([p = std::move(p)] { return ingest(p); }));
+            };
+            if (!fs::is_directory(in, ec)) {
+                submit(in);
+                continue;
+            }
+            for (const auto& e : fs::recursive_directory_iterator(in, ec))
+                if (e.is_regular_file(ec) && e.path().extension() == ".tsrr")
+                    submit(e.path());
+        }
+        while (!inFlight.empty())
+            drainOne();
+    }
+
+    header.games       = games.size();
+    header.occurrences = occurrences.size();
+    header.maxPiece    = maxPiece;
+    header.gamesOff    = db.offset();
+    db.write(games.data(), games.size() * sizeof(DbGame));
+    header.namesOff = db.offset();
+    db.write(names.data(), names.size());
+    db.align();
+    header.occOff = db.offset();
+
+    // 2. merge: occurrences stream straight into the file, one position per
+    //    run of equal hashes (to a side file, appended after), and one
+    //    (piece, count) row per piece that position was reached at
+    fs::path posPath = out;
+    posPath += ".positions";
+    std::FILE* posFile = std::fopen(posPath.string().c_str(), "w+b");
+    ExternalSorter<PieceRow, PieceRowLess> rows(fs::path(out).concat(".rows"), memMb << 20);
+    std::uint64_t positions = 0;
+    {
+        DbPosition cur{};
+        std::uint32_t lastGame = 0;
+        std::vector<std::uint32_t> pieces;
+        const auto closePosition = [&] {
+            if (cur.count == 0)
+                return;
+            if (positions > 0xFFFFFFFFull) {
+                ok = false; // position ids are u32
+                return;
+            }
+            ok = ok && std::fwrite(&cur, sizeof(cur), 1, posFile) == 1;
+            std::sort(pieces.begin(), pieces.end());
+            for (std::size_t i = 0; i < pieces.size();) {
+                std::size_t j = i;
+                while (j < pieces.size() && pieces[j] == pieces[i]) ++j;
+                ok = ok && rows.add({pieces[i], static_cast<std::uint32_t>(j - i), static_cast<std::uint32_t>(positions)});
+                i = j;
+            }
+            pieces.clear();
+            ++positions;
+        };
+        std::uint64_t index = 0;
+        ok = ok && posFile && occurrences.merge([&](const Occurrence& o) {
+            if (cur.count == 0 || o.hash.hi != cur.hi || o.hash.lo != cur.lo) {
+                closePosition();
+                cur = {o.hash.hi, o.hash.lo, index, 0, 0};
+            }
+            if (cur.count == 0 || o.game != lastGame)
+                ++cur.games;
+            ++cur.count;
+            lastGame = o.game;
+            pieces.push_back(o.piece);
+            db.put(DbOcc{o.game, o.piece});
+            ++index;
+        });
+        closePosition();
+    }
+    header.positions = positions;
+
+    // positions after the occurrences
+    header.posOff = db.offset();
+    if (posFile) {
+        std::rewind(posFile);
+        std::vector<char> buf(1 << 20);
+        std::size_t n;
+        while ((n = std::fread(buf.data(), 1, buf.size(), posFile)) > 0)
+            db.write(buf.data(), n);
+        std::fclose(posFile);
+    }
+    std::error_code ec;
+    fs::remove(posPath, ec);
+
+    // 3. piece rows by piece, most common first, and the directory over them
+    header.rowsOff = db.offset();
+    std::vector<std::uint64_t> dir(static_cast<std::size_t>(maxPiece) + 2, 0);
+    std::uint64_t rowCount = 0;
+    ok = ok && rows.merge([&](const PieceRow& r) {
+        db.put(DbPieceRow{r.position, r.count});
+        ++dir[static_cast<std::size_t>(r.piece) + 1];
+        ++rowCount;
+    });
+    for (std::size_t p = 1; p < dir.size(); ++p)
+        dir[p] += dir[p - 1];
+    header.pieceRows = rowCount;
+    header.dirOff    = db.offset();
+    db.write(dir.data(), dir.size() * sizeof(std::uint64_t));
+
+    if (!db.finish(header) || !ok) {
+        std::fprintf(stderr, "[PosDB] writing '%s' failed\n", out.string().c_str());
+        return 1;
+    }
+
+    const double wallS = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    std::printf("%llu games (%zu unreadable), %llu positions reached, %llu distinct (%.1f%%)\n",
+                static_cast<unsigned long long>(header.games), failed,
+                static_cast<unsigned long long>(header.occurrences), static_cast<unsigned long long>(positions),
+                header.occurrences > 0 ? 100.0 * static_cast<double>(positions) / static_cast<double>(header.occurrences) : 0.0);
+    std::printf("wrote %s (%.1f MB) in %.2f s on %u threads\n", out.string().c_str(),
+                static_cast<double>(fs::file_size(out, ec)) / 1e6, wallS, threads);
+    return failed == 0 ? 0 : 1;
+}
+
+// ---- queries ----------------------------------------------------------------
+
+class Db {
+public:
+    bool open(const fs::path& path) {
+        if (!m_file.open(path) || m_file.size() < sizeof(DbHeader))
+            return false;
+        std::memcpy(&m_h, m_file.data(), sizeof(m_h));
+        const std::uint64_t size = m_file.size();
+        const auto fits = [size](std::uint64_t off, std::uint64_t n, std::uint64_t each) {
+            return off <= size && n <= (size - off) / each;
+        };
+        return std::memcmp(m_h.magic, kDbMagic, sizeof(kDbMagic)) == 0 && m_h.version == kDbVersion
+            && fits(m_h.gamesOff, m_h.games, sizeof(DbGame))
+            && fits(m_h.occOff, m_h.occurrences, sizeof(DbOcc))
+            && fits(m_h.posOff, m_h.positions, sizeof(DbPosition))
+            && fits(m_h.rowsOff, m_h.pieceRows, sizeof(DbPieceRow))
+            && fits(m_h.dirOff, std::uint64_t{m_h.maxPiece} + 2, sizeof(std::uint64_t));
+    }
+
+    const DbHeader& header() const { return m_h; }
+
+    template<class T>
+    T at(std::uint64_t offset, std::uint64_t i) const {
+        T v;
+        std::memcpy(&v, m_file.data() + offset + i * sizeof(T), sizeof(T));
+        return v;
+    }
+    DbGame     game(std::uint64_t i) const     { return at<DbGame>(m_h.gamesOff, i); }
+    DbOcc      occ(std::uint64_t i) const      { return at<DbOcc>(m_h.occOff, i); }
+    DbPosition position(std::uint64_t i) const { return at<DbPosition>(m_h.posOff, i); }
+
+    std::string gameName(const DbGame& g) const {
+        if (g.name + g.nameLen > m_h.occOff - m_h.namesOff)
+            return {};
+        return std::string(reinterpret_cast<const char*>(m_file.data() + m_h.namesOff + g.name), g.nameLen);
+    }
+
+    // binary search over the sorted hashes
+    bool find(const BoardHash& h, DbPosition& out) const {
+        std::uint64_t lo = 0, hi = m_h.positions;
+        while (lo < hi) {
+            const std::uint64_t mid = lo + (hi - lo) / 2;
+            const DbPosition p = position(mid);
+            if (BoardHash{p.hi, p.lo} < h) lo = mid + 1;
+            else                           hi = mid;
+        }
+        if (lo == m_h.positions)
+            return false;
+        out = position(lo);
+        return out.hi == h.hi && out.lo == h.lo;
+    }
+
+    // a board for display: replay the first game that reached it
+    bool board(const DbPosition& p, Board& out) const {
+        if (p.count == 0)
+            return false;
+        const DbOcc o = occ(p.firstOcc);
+        return boardAt(gameName(game(o.game)), static_cast<int>(o.piece), out);
+    }
+
+private:
+    MappedFile m_file;
+    DbHeader   m_h{};
+};
+
+static bool openDb(const char* path, Db& db) {
+    if (db.open(path))
+        return true;
+    std::fprintf(stderr, "[PosDB] %s is not a position database\n", path);
+    return false;
+}
+
+static int queryInfo(int argc, char** argv) {
+    Db db;
+    if (argc != 1)
+        return 2;
+    if (!openDb(argv[0], db))
+        return 1;
+    const DbHeader& h = db.header();
+    std::printf("games        %llu\n", static_cast<unsigned long long>(h.games));
+    std::printf("positions    %llu distinct of %llu reached\n",
+                static_cast<unsigned long long>(h.positions), static_cast<unsigned long long>(h.occurrences));
+    std::printf("piece rows   %llu (pieces 1..%u)\n", static_cast<unsigned long long>(h.pieceRows), h.maxPiece);
+    return 0;
+}
+
+static int queryGames(int argc, char** argv) {
+    const char* dbPath = nullptr;
+    std::string at, boardPath;
+    std::uint64_t limit = 50;
+    for (int i = 0; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--at") == 0 && i + 1 < argc)         at = argv[++i];
+        else if (std::strcmp(argv[i], "--board") == 0 && i + 1 < argc) boardPath = argv[++i];
+        else if (std::strcmp(argv[i], "--limit") == 0 && i + 1 < argc) limit = static_cast<std::uint64_t>(std::max(1, std::atoi(argv[++i])));
+        else if (argv[i][0] != '-' && !dbPath)                           dbPath = argv[i];
+        else return 2;
+    }
+    if (!dbPath || at.empty() == boardPath.empty())
+        return 2;
+
+    Board board{};
+    if (!at.empty()) {
+        const std::size_t colon = at.rfind(':');
+        if (colon == std::string::npos || !boardAt(at.substr(0, colon), std::atoi(at.c_str() + colon + 1), board)) {
+            std::fprintf(stderr, "[PosDB] can't get a board from '%s' (want replay.tsrr:PIECE)\n", at.c_str());
+            return 1;
+        }
+    } else if (!readBoardFile(boardPath, board)) {
+        std::fprintf(stderr, "[PosDB] %s: want up to %d rows of %d cells ('.' = empty)\n", boardPath.c_str(), ROWS, COLS);
+        return 1;
+    }
+
+    Db db;
+    if (!openDb(dbPath, db))
+        return 1;
+    printBoard(board);
+    DbPosition p;
+    if (!db.find(hashBoard(board), p)) {
+        std::printf("never reached\n");
+        return 0;
+    }
+    std::printf("reached %u times in %u games\n", p.count, p.games);
+    for (std::uint64_t i = 0; i < p.count && i < limit; ++i) {
+        const DbOcc  o = db.occ(p.firstOcc + i);
+        const DbGame g = db.game(o.game);
+        std::printf("  piece %-5u %-7s %016llx  %s\n", o.piece, runTypeName(static_cast<RunType>(g.run)),
+                    static_cast<unsigned long long>(g.seed), db.gameName(g).c_str());
+    }
+    if (p.count > limit)
+        std::printf("  ... %llu more\n", static_cast<unsigned long long>(p.count - limit));
+    return 0;
+}
+
+static int queryCommon(int argc, char** argv) {
+    const char* dbPath = nullptr;
+    long piece = -1;
+    std::uint64_t top = 10;
+    for (int i = 0; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--piece") == 0 && i + 1 < argc)    piece = std::atol(argv[++i]);
+        else if (std::strcmp(argv[i], "--top") == 0 && i + 1 < argc) top = static_cast<std::uint64_t>(std::max(1, std::atoi(argv[++i])));
+        else if (argv[i][0] != '-' && !dbPath)                        dbPath = argv[i];
+        else return 2;
+    }
+    if (!dbPath || piece < 1)
+        return 2;
+
+    Db db;
+    if (!openDb(dbPath, db))
+        return 1;
+    const DbHeader& h = db.header();
+    if (static_cast<std::uint64_t>(piece) > h.maxPiece) {
+        std::printf("no game reached piece %ld\n", piece);
+        return 0;
+    }
+    const auto first = db.at<std::uint64_t>(h.dirOff, static_cast<std::uint64_t>(piece));
+    const auto last  = db.at<std::uint64_t>(h.dirOff, static_cast<std::uint64_t>(piece) + 1);
+    std::printf("%llu distinct positions after piece %ld\n", static_cast<unsigned long long>(last - first), piece);
+    for (std::uint64_t i = first; i < last && i < first + top; ++i) {
+        const DbPieceRow row = db.at<DbPieceRow>(h.rowsOff, i);
+        const DbPosition p   = db.position(row.position);
+        std::printf("#%llu  %u times here (%u overall, %u games)  %016llx%016llx\n",
+                    static_cast<unsigned long long>(i - first + 1), row.count, p.count, p.games,
+                    static_cast<unsigned long long>(p.hi), static_cast<unsigned long long>(p.lo));
+        Board board;
+        if (db.board(p, board))
+            printBoard(board);
+    }
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    static const char* const kUsage =
+        "usage: %s build [--threads N] [--mem MB] <out.tspd> <replay.tsrr | directory>...\n"
+        "       %s info   <db.tspd>\n"
+        "       %s games  <db.tspd> (--at replay.tsrr:PIECE | --board file.txt) [--limit N]\n"
+        "       %s common <db.tspd> --piece N [--top K]\n";
+
+    int rc = 2;
+    if (argc >= 2) {
+        const char* cmd = argv[1];
+        if (std::strcmp(cmd, "build") == 0)       rc = build(argc - 2, argv + 2);
+        else if (std::strcmp(cmd, "info") == 0)   rc = queryInfo(argc - 2, argv + 2);
+        else if (std::strcmp(cmd, "games") == 0)  rc = queryGames(argc - 2, argv + 2);
+        else if (std::strcmp(cmd, "common") == 0) rc = queryCommon(argc - 2, argv + 2);
+    }
+    if (rc == 2)
+        std::fprintf(stderr, kUsage, argv[0], argv[0], argv[0], argv[0]);
+    return rc;
+}
@@ -0,0 +1,407 @@
+// tools/replay_stats.cpp
+// Per-run and aggregate statistics over a corpus of replays.
+//
+//   replay_stats [--threads N] [--out file] [--format csv|bin] <replay.tsrr | directory>...
+//
+// Each replay is played back through the game's own Simulation, so the
+// numbers are exactly what happened in the run: pieces per second, keys per
+// piece, singles/doubles/triples/quads, holds, DAS/ARR/SDF and the time of
+// every 10-line split up to 40. One row per run goes to --out (CSV, or a
+// columnar binary file with the layout below); the aggregate is printed.
+//
+// Directories are walked lazily and at most a few jobs per thread are in
+// flight, so memory stays flat however many replays there are. Rows come
+// out in input order.
+//
+// Binary layout (little-endian):
+//   magic "TSRSSTA\0", u32 version, u32 columns,
+//   per column: u8 type ('f' = f64, 's' = string), u8 nameLen, name
+//   row groups of up to kRowGroup rows: u32 rows, then column by column
+//     f64 x rows, or for strings (u32 len, bytes) x rows
+//   a row group with 0 rows ends the file
+#include "core/MappedFile.hpp"
+#include "core/ThreadPool.hpp"
+#include "game/Replay.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <limits>
+#include <map>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+using namespace Tetris;
+namespace fs = std::filesystem;
+
+static constexpr int         kSplits   = 4;    // 10, 20, 30, 40 lines
+static constexpr std::size_t kRowGroup = 4096;
+
+enum Col : std::size_t {
+    ColDasMs, ColArrMs, ColSdf, ColSeconds, ColPieces, ColLines, ColPps,
+    ColKeys, ColKpp, ColSingles, ColDoubles, ColTriples, ColQuads,
+    ColHolds, ColHoldRate, ColFinished, ColSplit10,
+    kNumeric = ColSplit10 + kSplits
+};
+
+static const char* const kStringColumns[]  = {"file", "run", "seed"};
+static const char* const kNumericColumns[] = {
+    "das_ms", "arr_ms", "sdf", "seconds", "pieces", "lines", "pps",
+    "keys", "keys_per_piece", "singles", "doubles", "triples", "quads",
+    "holds", "holds_per_piece", "finished", "split10_s", "split20_s", "split30_s", "split40_s"};
+static_assert(std::size(kNumericColumns) == kNumeric);
+
+struct Row {
+    bool        ok = false;
+    std::string error;
+    std::string file, run, seed;
+    std::array<double, kNumeric> v{};
+};
+
+// ---- one replay -------------------------------------------------------------
+
+static Row analyse(const fs::path& path) {
+    Row row;
+    row.file = path.string();
+
+    MappedFile    file;
+    ReplayDecoder dec;
+    if (!file.open(path) || !dec.open({file.data(), file.size()})) {
+        row.error = "not a readable replay";
+        return row;
+    }
+    const ReplayHeader& h = dec.header();
+
+    Simulation sim;
+    sim.reset(h.runType, h.settings, h.seed);
+
+    int keys = 0, holds = 0, pieces = 0, lines = 0, nextSplit = 0;
+    std::array<int, 4> clears{};
+    std::array<double, kSplits> splits;
+    splits.fill(std::numeric_limits<double>::quiet_NaN());
+
+    // piece locks come from inputs and from gravity alike: look after
+    // every step so clears and splits get the exact lock time
+    const auto observe = [&] {
+        const GameState& s = sim.state();
+        if (s.piecesPlaced == pieces)
+            return;
+        const int cleared = s.totalLinesCleared - lines;
+        if (cleared > 0)
+            ++clears[static_cast<std::size_t>(std::min(cleared, 4) - 1)];
+        while (nextSplit < kSplits && s.totalLinesCleared >= (nextSplit + 1) * 10)
+            splits[static_cast<std::size_t>(nextSplit++)] = static_cast<double>(sim.timeUs()) / 1e6;
+        pieces = s.piecesPlaced;
+        lines  = s.totalLinesCleared;
+    };
+    const auto runTo = [&](std::int64_t t) {
+        while (sim.timeUs() < t) {
+            sim.advanceTo(std::min(t, sim.timeUs() + Simulation::kStepUs));
+            observe();
+        }
+    };
+
+    InputEvent in;
+    while (dec.next(in)) {
+        runTo(in.timeUs);
+        if (in.pressed && !sim.state().gameOver) {
+            ++keys;
+            if (in.action == InputAction::Hold && sim.state().canHold)
+                ++holds;
+        }
+        sim.apply(in);
+        observe();
+    }
+    if (!dec.finished()) {
+        row.error = dec.error() ? "corrupt input stream" : "no end record";
+        return row;
+    }
+    runTo(dec.result().endTimeUs);
+
+    const double seconds = static_cast<double>(dec.result().endTimeUs) / 1e6;
+    const double perPiece = pieces > 0 ? 1.0 / pieces : 0.0;
+
+    char seed[24];
+    std::snprintf(seed, sizeof(seed), "%016llx", static_cast<unsigned long long>(h.seed));
+    row.run  = runTypeName(h.runType);
+    row.seed = seed;
+
+    auto& v = row.v;
+    v[ColDasMs]    = h.settings.das * 1000.0;
+    v[ColArrMs]    = h.settings.arr * 1000.0;
+    v[ColSdf]      = h.settings.sdf;
+    v[ColSeconds]  = seconds;
+    v[ColPieces]   = pieces;
+    v[ColLines]    = lines;
+    v[ColPps]      = seconds > 0.0 ? pieces / seconds : 0.0;
+    v[ColKeys]     = keys;
+    v[ColKpp]      = keys * perPiece;
+    v[ColSingles]  = clears[0];
+    v[ColDoubles]  = clears[1];
+    v[ColTriples]  = clears[2];
+    v[ColQuads]    = clears[3];
+    v[ColHolds]    = holds;
+    v[ColHoldRate] = holds * perPiece;
+    v[ColFinished] = (h.runType == RunType::Sprint && dec.result().gameOver && lines >= 40) ? 1.0 : 0.0;
+    for (int i = 0; i < kSplits; ++i)
+        v[ColSplit10 + static_cast<std::size_t>(i)] = splits[static_cast<std::size_t>(i)];
+
+    row.ok = true;
+    return row;
+}
+
+// ---- output -----------------------------------------------------------------
+
+static void writeCsvField(std::ofstream& out, const std::string& s) {
+    if (s.find_first_of(",\"\n") == std::string::npos) {
+        out << s;
+        return;
+    }
+    out << '"';
+    for (char c : s) {
+        if (c == '"') out << '"';
+        out << c;
+    }
+    out << '"';
+}
+
+class RowWriter {
+public:
+    bool open(const fs::path& path, bool binary) {
+        m_binary = binary;
+        m_out.open(path, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!m_out)
+            return false;
+
+        if (!m_binary) {
+            const char* sep = "";
+            for (const char* c : kStringColumns)  { m_out << sep << c; sep = ","; }
+            for (const char* c : kNumericColumns) { m_out << sep << c; }
+            m_out << '\n';
+            return true;
+        }
+
+        m_out.write("TSRSSTA", 8);
+        putU32(1);
+        putU32(static_cast<std::uint32_t>(std::size(kStringColumns) + kNumeric));
+        const auto column = [this](char type, const char* name) {
+            const auto len = static_cast<std::uint8_t>(std::strlen(name));
+            m_out.put(type);
+            m_out.put(static_cast<char>(len));
+            m_out.write(name, len);
+        };
+        for (const char* c : kStringColumns)  column('s', c);
+        for (const char* c : kNumericColumns) column('f', c);
+        return true;
+    }
+
+    void write(Row&& row) {
+        if (!m_binary) {
+            writeCsvField(m_out, row.file);
+            m_out << ',' << row.run << ',' << row.seed;
+            char buf[32];
+            for (double x : row.v) {
+                if (std::isnan(x)) {
+                    m_out << ',';
+                } else {
+                    std::snprintf(buf, sizeof(buf), ",%.6g", x);
+                    m_out << buf;
+                }
+            }
+            m_out << '\n';
+            return;
+        }
+        m_group.push_back(std::move(row));
+        if (m_group.size() == kRowGroup)
+            flushGroup();
+    }
+
+    bool close() {
+        if (m_binary) {
+            flushGroup();
+            putU32(0);
+        }
+        m_out.close();
+        return static_cast<bool>(m_out);
+    }
+
+private:
+    void putU32(std::uint32_t v) {
+        char b[4];
+        for (int i = 0; i < 4; ++i) b[i] = static_cast<char>(v >> (8 * i));
+        m_out.write(b, 4);
+    }
+    void putF64(double v) {
+        std::uint64_t bits;
+        std::memcpy(&bits, &v, sizeof(bits));
+        char b[8];
+        for (int i = 0; i < 8; ++i) b[i] = static_cast<char>(bits >> (8 * i));
+        m_out.write(b, 8);
+    }
+
+    // one row group, column after column
+    void flushGroup() {
+        if (m_group.empty())
+            return;
+        putU32(static_cast<std::uint32_t>(m_group.size()));
+        for (std::string Row::* col : {&Row::file, &Row::run, &Row::seed}) {
+            for (const Row& r : m_group) {
+                const std::string& s = r.*col;
+                putU32(static_cast<std::uint32_t>(s.size()));
+                m_out.write(s.data(), static_cast<std::streamsize>(s.size()));
+            }
+        }
+        for (std::size_t c = 0; c < kNumeric; ++c)
+            for (const Row& r : m_group)
+                putF64(r.v[c]);
+        m_group.clear();
+    }
+
+    std::ofstream    m_out;
+    bool             m_binary = false;
+    std::vector<Row> m_group;
+};
+
+// ---- aggregate --------------------------------------------------------------
+
+struct Totals {
+    std::size_t runs = 0, failed = 0;
+    double seconds = 0, pieces = 0, lines = 0, keys = 0, holds = 0;
+    std::array<double, 4> clears{};
+    std::array<double, kSplits> splitSum{};
+    std::array<int, kSplits>    splitRuns{};
+    std::map<std::pair<int, int>, int> dasArr; // (das ms, arr ms) -> runs
+
+    void add(const Row& r) {
+        ++runs;
+        seconds += r.v[ColSeconds];
+        pieces  += r.v[ColPieces];
+        lines   += r.v[ColLines];
+        keys    += r.v[ColKeys];
+        holds   += r.v[ColHolds];
+        for (std::size_t i = 0; i < 4; ++i)
+            clears[i] += r.v[ColSingles + i];
+        for (std::size_t i = 0; i < kSplits; ++i) {
+            const double s = r.v[ColSplit10 + i];
+            if (!std::isnan(s)) {
+                splitSum[i] += s;
+                ++splitRuns[i];
+            }
+        }
+        ++dasArr[{static_cast<int>(std::lround(r.v[ColDasMs])), static_cast<int>(std::lround(r.v[ColArrMs]))}];
+    }
+
+    void print() const {
+        std::printf("runs          %zu (%zu unreadable)\n", runs, failed);
+        if (runs == 0)
+            return;
+        std::printf("play time     %.1f s, %.0f pieces, %.0f lines\n", seconds, pieces, lines);
+        std::printf("PPS           %.3f\n", seconds > 0 ? pieces / seconds : 0.0);
+        std::printf("keys / piece  %.3f\n", pieces > 0 ? keys / pieces : 0.0);
+        std::printf("holds / piece %.3f\n", pieces > 0 ? holds / pieces : 0.0);
+        const double allClears = clears[0] + clears[1] + clears[2] + clears[3];
+        static const char* const kNames[] = {"singles", "doubles", "triples", "quads"};
+        for (std::size_t i = 0; i < 4; ++i)
+            std::printf("%-13s %.0f (%.1f%%)\n", kNames[i], clears[i], allClears > 0 ? 100.0 * clears[i] / allClears : 0.0);
+        for (std::size_t i = 0; i < kSplits; ++i)
+            if (splitRuns[i] > 0)
+                std::printf("%2zu lines      mean %.3f s over %d runs\n", (i + 1) * 10, splitSum[i] / splitRuns[i], splitRuns[i]);
+        const auto common = std::max_element(dasArr.begin(), dasArr.end(),
+                                              [](const auto& a, const auto& b) { return a.second < b.second; });
+        std::printf("DAS/ARR       most used %d/%d ms (%d runs, %zu distinct)\n",
+                    common->first.first, common->first.second, common->second, dasArr.size());
+    }
+};
+
+// ---- driver -----------------------------------------------------------------
+
+int main(int argc, char** argv) {
+    unsigned threads = ThreadPool::defaultThreadCount();
+    fs::path outPath;
+    bool binary = false;
+    std::vector<fs::path> inputs;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = static_cast<unsigned>(std::max(1, std::atoi(argv[++i])));
+        } else if (std::strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+            outPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--format") == 0 && i + 1 < argc) {
+            binary = std::strcmp(argv[++i], "bin") == 0;
+        } else if (argv[i][0] == '-') {
+            std::fprintf(stderr, "usage: %s [--threads N] [--out file] [--format csv|bin] <replay.tsrr | directory>...\n", argv[0]);
+            return 2;
+        } else {
+            inputs.emplace_back(argv[i]);
+        }
+    }
+    if (inputs.empty()) {
+        std::fprintf(stderr, "[Stats] no replays given\n");
+        return 2;
+    }
+
+    RowWriter writer;
+    if (!outPath.empty() && !writer.open(outPath, binary)) {
+        std::fprintf(stderr, "[Stats] could not create '%s'\n", outPath.string().c_str());
+        return 1;
+    }
+
+    const auto t0 = std::chrono::steady_clock::now();
+    Totals totals;
+    {
+        ThreadPool pool(threads);
+        const std::size_t maxInFlight = pool.size() * 4;
+        std::deque<std::future<Row>> inFlight;
+
+        const auto drainOne = [&] {
+            Row row = inFlight.front().get();
+            inFlight.pop_front();
+            if (!row.ok) {
+                ++totals.failed;
+                std::fprintf(stderr, "[Stats] %s: %s\n", row.file.c_str(), row.error.c_str());
+                return;
+            }
+            totals.add(row);
+            if (!outPath.empty())
+                writer.write(std::move(row));
+        };
+        const auto submit = [&](fs::path p) {
+            if (inFlight.size() >= maxInFlight)
+                drainOne();
+            inFlight.push_back(pool.submit([p = std::move(p)] { return analyse(p); }));
+        };
+
+        for (const fs::path& in : inputs) {
+            std::error_code ec;
+            if (!fs::is_directory(in, ec)) {
+                submit(in);
+                continue;
+            }
+            for (const auto& e : fs::recursive_directory_iterator(in, ec))
+                if (e.is_regular_file(ec) && e.path().extension() == ".tsrr")
+                    submit(e.path());
+        }
+        while (!inFlight.empty())
+            drainOne();
+    }
+    const double wallMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+
+    if (!outPath.empty() && !writer.close()) {
+        std::fprintf(stderr, "[Stats] write to '%s' failed\n", outPath.string().c_str());
+        return 1;
+    }
+
+    totals.print();
+    std::printf("analysed in %.1f ms on %u threads\n", wallMs, threads);
+    return totals.failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,149 @@
+// tools/replay_verify.cpp
+// Re-simulates replays headlessly and checks the result each one claims.
+//
+//   replay_verify [--threads N] [--quiet] <replay.tsrr | directory>...
+//
+// Every replay is rebuilt from its seed and settings and its inputs are fed
+// through the game's own Simulation (DAS/ARR, gravity, lock delay, SRS), so
+// the lines, pieces and sprint time it ends with must match the end record
+// exactly. Directories are scanned for *.tsrr; files are verified in
+// parallel. Exit code 0 only if every replay verified.
+#include "core/MappedFile.hpp"
+#include "core/ThreadPool.hpp"
+#include "game/Replay.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <future>
+#include <string>
+#include <system_error>
+#include <vector>
+
+using namespace Tetris;
+namespace fs = std::filesystem;
+
+struct Verdict {
+    bool          ok = false;
+    std::string   reason;  // why it failed
+    RunType       run = RunType::Endless;
+    ReplayResult  claimed;
+    double        verifyMs = 0.0;
+};
+
+static Verdict verify(const fs::path& path) {
+    const auto t0 = std::chrono::steady_clock::now();
+    Verdict v;
+
+    MappedFile   file;
+    ReplayPlayer player;
+    if (!file.open(path)) {
+        v.reason = "unreadable";
+    } else if (!player.open({file.data(), file.size()})) {
+        v.reason = "not a replay (bad header or version)";
+    } else {
+        player.runToEnd();
+
+        const ReplayDecoder& dec = player.decoder();
+        const GameState&     s   = player.sim().state();
+        v.run     = dec.header().runType;
+        v.claimed = dec.result();
+
+        char buf[128];
+        if (dec.error()) {
+            v.reason = "corrupt input stream";
+        } else if (!dec.finished()) {
+            v.reason = "no end record";
+        } else if (static_cast<std::uint32_t>(s.totalLinesCleared) != v.claimed.lines) {
+            std::snprintf(buf, sizeof(buf), "lines: claims %u, replays to %d", v.claimed.lines, s.totalLinesCleared);
+            v.reason = buf;
+        } else if (static_cast<std::uint32_t>(s.piecesPlaced) != v.claimed.pieces) {
+            std::snprintf(buf, sizeof(buf), "pieces: claims %u, replays to %d", v.claimed.pieces, s.piecesPlaced);
+            v.reason = buf;
+        } else if (s.sprintTimeUs != v.claimed.sprintTimeUs) {
+            std::snprintf(buf, sizeof(buf), "time: claims %lld us, replays to %lld us",
+                          static_cast<long long>(v.claimed.sprintTimeUs), static_cast<long long>(s.sprintTimeUs));
+            v.reason = buf;
+        } else if (s.gameOver != v.claimed.gameOver) {
+            v.reason = v.claimed.gameOver ? "claims the run ended, replay is still going" : "claims abandoned, replay ended";
+        } else {
+            v.ok = true;
+        }
+    }
+
+    v.verifyMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    return v;
+}
+
+static void collect(const fs::path& arg, std::vector<fs::path>& out) {
+    std::error_code ec;
+    if (!fs::is_directory(arg, ec)) {
+        out.push_back(arg);
+        return;
+    }
+    const std::size_t first = out.size();
+    for (const auto& e : fs::recursive_directory_iterator(arg, ec))
+        if (e.is_regular_file(ec) && e.path().extension() == ".tsrr")
+            out.push_back(e.path());
+    std::sort(out.begin() + static_cast<std::ptrdiff_t>(first), out.end()); // file names start with the unix time
+}
+
+int main(int argc, char** argv) {
+    unsigned threads = ThreadPool::defaultThreadCount();
+    bool quiet = false;
+    std::vector<fs::path> files;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = static_cast<unsigned>(std::max(1, std::atoi(argv[++i])));
+        } else if (std::strcmp(argv[i], "--quiet") == 0) {
+            quiet = true;
+        } else if (argv[i][0] == '-') {
+            std::fprintf(stderr, "usage: %s [--threads N] [--quiet] <replay.tsrr | directory>...\n", argv[0]);
+            return 2;
+        } else {
+            collect(argv[i], files);
+        }
+    }
+    if (files.empty()) {
+        std::fprintf(stderr, "[Verify] no replays given\n");
+        return 2;
+    }
+
+    const auto t0 = std::chrono::steady_clock::now();
+    std::vector<std::future<Verdict>> results;
+    results.reserve(files.size());
+    {
+        ThreadPool pool(std::min<unsigned>(threads, static_cast<unsigned>(files.size())));
+        for (const auto& f : files)
+            results.push_back(pool.submit([f] { return verify(f); }));
+    }
+    const double wallMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+
+    std::size_t passed = 0;
+    double gameSeconds = 0.0;
+    for (std::size_t i = 0; i < files.size(); ++i) {
+        const Verdict v = results[i].get();
+        gameSeconds += static_cast<double>(v.claimed.endTimeUs) / 1e6;
+        if (v.ok) {
+            ++passed;
+            if (quiet)
+                continue;
+            const bool finished = v.claimed.gameOver && v.run == RunType::Sprint && v.claimed.lines >= 40;
+            std::printf("OK    %-7s %4u lines %5u pieces %9.3f s%s  (%.2f ms)  %s\n",
+                        runTypeName(v.run), v.claimed.lines, v.claimed.pieces,
+                        static_cast<double>(v.run == RunType::Sprint ? v.claimed.sprintTimeUs : v.claimed.endTimeUs) / 1e6,
+                        finished ? " 40L" : (v.claimed.gameOver ? "    " : " abn"),
+                        v.verifyMs, files[i].string().c_str());
+        } else {
+            std::printf("FAIL  %s  %s\n", v.reason.c_str(), files[i].string().c_str());
+        }
+    }
+
+    std::printf("%zu/%zu verified in %.1f ms (%.0fx real time)\n", passed, files.size(), wallMs,
+                wallMs > 0.0 ? gameSeconds * 1000.0 / wallMs : 0.0);
+    return passed == files.size() ? 0 : 1;
+}
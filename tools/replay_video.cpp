@@ -0,0 +1,268 @@
+// tools/replay_video.cpp
+// Renders a replay offscreen, exactly as the game draws it, to raw Y4M video.
+//
+//   replay_video [--fps N] [--size WxH] [--tail S] [--race pb.tsrr] [--threads N]
+//                [--software] [--out file.y4m | -] <replay.tsrr>
+//
+// The replay is played back through the game's Simulation and every frame
+// goes through PlayfieldRenderer + Hud into an sf::RenderTexture at a fixed
+// frame rate (the HUD's FPS counter stays blank). `--out -` writes to
+// stdout, e.g. `replay_video run.tsrr --out - | ffmpeg -i - run.mp4`.
+//
+// The frame loop is pipelined: two render textures take turns, so frame N+1
+// is submitted to the GL driver before frame N is read back, and the read
+// never waits on work queued after it. RGB -> YUV 4:2:0 conversion runs on
+// a worker pool and a single writer thread emits frames in order; at most a
+// few frames are in flight, so memory stays flat for any length of replay.
+// --software selects Mesa's llvmpipe rasteriser (as in bench_render) for
+// machines without a GPU.
+#include "core/MappedFile.hpp"
+#include "core/ResourceCache.hpp"
+#include "core/ThreadPool.hpp"
+#include "game/Replay.hpp"
+#include "game/Snapshot.hpp"
+#include "render/Colors.hpp"
+#include "render/Hud.hpp"
+#include "render/InstrumentedTarget.hpp"
+#include "render/PlayfieldRenderer.hpp"
+
+#include <SFML/Graphics/Image.hpp>
+#include <SFML/Graphics/RenderTexture.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+using namespace Tetris;
+namespace fs = std::filesystem;
+
+namespace {
+
+// One render texture with its own renderers (they hold on to their target).
+struct Lane {
+    sf::RenderTexture  rt;
+    InstrumentedTarget target{rt};
+    PlayfieldRenderer  playfield{target};
+    Hud                hud{target};
+};
+
+// BT.601 studio range, chroma averaged over each 2x2 block (centre sited,
+// which is what C420jpeg declares).
+std::vector<std::uint8_t> toI420(const sf::Image& img) {
+    const unsigned w = img.getSize().x, h = img.getSize().y;
+    const std::uint8_t* px = img.getPixelsPtr(); // RGBA, top row first
+    std::vector<std::uint8_t> out(static_cast<std::size_t>(w) * h * 3 / 2);
+    std::uint8_t* yPlane = out.data();
+    std::uint8_t* uPlane = yPlane + static_cast<std::size_t>(w) * h;
+    std::uint8_t* vPlane = uPlane + static_cast<std::size_t>(w / 2) * (h / 2);
+
+    for (unsigned y = 0; y < h; y += 2) {
+        for (unsigned x = 0; x < w; x += 2) {
+            int r = 0, g = 0, b = 0;
+            for (unsigned dy = 0; dy < 2; ++dy) {
+                for (unsigned dx = 0; dx < 2; ++dx) {
+                    const std::uint8_t* p = px + (static_cast<std::size_t>(y + dy) * w + x + dx) * 4;
+                    yPlane[static_cast<std::size_t>(y + dy) * w + x + dx] =
+                        static_cast<std::uint8_t>(((66 * p[0] + 129 * p[1] + 25 * p[2] + 128) >> 8) + 16);
+                    r += p[0]; g += p[1]; b += p[2];
+                }
+            }
+            r = (r + 2) / 4; g = (g + 2) / 4; b = (b + 2) / 4;
+            const std::size_t c = static_cast<std::size_t>(y / 2) * (w / 2) + x / 2;
+            uPlane[c] = static_cast<std::uint8_t>(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+            vPlane[c] = static_cast<std::uint8_t>(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+        }
+    }
+    return out;
+}
+
+// Where the replay ends: the end record, or the last input of a cut-off file.
+std::int64_t replayEndUs(std::span<const std::uint8_t> bytes) {
+    ReplayDecoder dec;
+    if (!dec.open(bytes))
+        return 0;
+    InputEvent in;
+    std::int64_t last = 0;
+    while (dec.next(in))
+        last = in.timeUs;
+    return dec.finished() ? dec.result().endTimeUs : last;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int fps = 60;
+    unsigned width = 1920, height = 1080;
+    double tailS = 2.0;
+    unsigned threads = std::min(ThreadPool::defaultThreadCount(), 8u);
+    bool software = false;
+    fs::path input, outPath, racePath;
+
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--fps") && i + 1 < argc) {
+            fps = std::clamp(std::atoi(argv[++i]), 1, 1000);
+        } else if (!std::strcmp(argv[i], "--size") && i + 1 < argc) {
+            if (std::sscanf(argv[++i], "%ux%u", &width, &height) != 2 || width < 2 || height < 2
+                || width % 2 != 0 || height % 2 != 0) {
+                std::fprintf(stderr, "replay_video: --size expects even WxH\n");
+                return 2;
+            }
+        } else if (!std::strcmp(argv[i], "--tail") && i + 1 < argc) {
+            tailS = std::max(0.0, std::atof(argv[++i]));
+        } else if (!std::strcmp(argv[i], "--race") && i + 1 < argc) {
+            racePath = argv[++i];
+        } else if (!std::strcmp(argv[i], "--threads") && i + 1 < argc) {
+            threads = static_cast<unsigned>(std::max(1, std::atoi(argv[++i])));
+        } else if (!std::strcmp(argv[i], "--software")) {
+            software = true;
+        } else if (!std::strcmp(argv[i], "--out") && i + 1 < argc) {
+            outPath = argv[++i];
+        } else if (argv[i][0] == '-' || !input.empty()) {
+            std::fprintf(stderr, "usage: replay_video [--fps N] [--size WxH] [--tail S] [--race pb.tsrr] [--threads N]\n"
+                                 "                    [--software] [--out file.y4m | -] <replay.tsrr>\n");
+            return 2;
+        } else {
+            input = argv[i];
+        }
+    }
+    if (input.empty()) {
+        std::fprintf(stderr, "replay_video: no replay given\n");
+        return 2;
+    }
+    if (outPath.empty())
+        outPath = fs::path(input).replace_extension(".y4m");
+
+    if (software) {
+#ifndef _WIN32
+        // must happen before SFML creates its first GL context
+        setenv("LIBGL_ALWAYS_SOFTWARE", "1", 0);
+        setenv("GALLIUM_DRIVER", "llvmpipe", 0);
+#else
+        std::fprintf(stderr, "replay_video: --software is ignored on Windows\n");
+#endif
+    }
+
+    MappedFile   file;
+    ReplayPlayer player;
+    if (!file.open(input) || !player.open({file.data(), file.size()})) {
+        std::fprintf(stderr, "replay_video: %s is not a replay\n", input.string().c_str());
+        return 1;
+    }
+    MappedFile   raceFile;
+    ReplayPlayer race;
+    const bool racing = !racePath.empty() && raceFile.open(racePath) && race.open({raceFile.data(), raceFile.size()});
+    if (!racePath.empty() && !racing)
+        std::fprintf(stderr, "replay_video: can't race '%s', rendering without it\n", racePath.string().c_str());
+
+    const std::int64_t endUs    = replayEndUs({file.data(), file.size()});
+    const std::int64_t raceEnd  = racing ? replayEndUs({raceFile.data(), raceFile.size()}) : 0;
+    const std::int64_t lengthUs = endUs + static_cast<std::int64_t>(tailS * 1e6);
+    const auto frames = static_cast<std::int64_t>(lengthUs * fps / 1'000'000) + 1;
+
+    std::array<std::unique_ptr<Lane>, 2> lanes;
+    for (auto& lane : lanes) {
+        lane = std::make_unique<Lane>();
+        if (!lane->rt.resize({width, height})) {
+            std::fprintf(stderr, "replay_video: could not create a %ux%u render texture\n", width, height);
+            return 1;
+        }
+    }
+    ResourceCache resources;
+    const auto font = resources.font("fonts/DejaVuSans.ttf");
+    if (font)
+        for (auto& lane : lanes)
+            lane->hud.setFont(*font);
+    else
+        std::fprintf(stderr, "replay_video: font missing, the HUD has no text\n");
+
+    const bool toStdout = outPath == "-";
+#ifdef _WIN32
+    if (toStdout) // text mode would turn every 0x0A byte of a frame into CR LF
+        _setmode(_fileno(stdout), _O_BINARY);
+#endif
+    std::FILE* out = toStdout ? stdout : std::fopen(outPath.string().c_str(), "wb");
+    if (!out) {
+        std::fprintf(stderr, "replay_video: could not create '%s'\n", outPath.string().c_str());
+        return 1;
+    }
+    std::fprintf(out, "YUV4MPEG2 W%u H%u F%d:1 Ip A1:1 C420jpeg\n", width, height, fps);
+
+    const auto t0 = std::chrono::steady_clock::now();
+    bool ok = true;
+    {
+        ThreadPool encoders(threads);
+        ThreadPool writer(1);
+        const std::size_t maxInFlight = encoders.size() + 2;
+        std::deque<std::future<bool>> inFlight;
+
+        // hand a finished frame to the encoders; the writer takes them in order
+        const auto emit = [&](Lane& lane) {
+            auto yuv = encoders.submit([image = lane.rt.getTexture().copyToImage()] { return toI420(image); });
+            inFlight.push_back(writer.submit([out, yuv = std::move(yuv)]() mutable {
+                const std::vector<std::uint8_t> frame = yuv.get();
+                return std::fwrite("FRAME\n", 1, 6, out) == 6
+                    && std::fwrite(frame.data(), 1, frame.size(), out) == frame.size();
+            }));
+            while (inFlight.size() > maxInFlight) {
+                ok = inFlight.front().get() && ok;
+                inFlight.pop_front();
+            }
+        };
+
+        RenderSnapshot snap;
+        for (std::int64_t f = 0; f < frames && ok; ++f) {
+            // frames past the end hold on the last one
+            const std::int64_t t = std::min(f * 1'000'000 / fps, endUs);
+            player.advanceTo(t);
+            player.sim().snapshot(snap);
+            if (racing) {
+                race.advanceTo(std::min(t, raceEnd));
+                fillRaceSnapshot(race.sim().state(), snap.race);
+            }
+
+            Lane& lane = *lanes[static_cast<std::size_t>(f % 2)];
+            lane.target.beginFrame();
+            lane.rt.clear(Colors::Bg);
+            lane.playfield.draw(snap);
+            lane.target.setView(lane.target.getDefaultView());
+            lane.hud.draw(snap);
+            lane.rt.display();
+
+            // the previous frame is read while this one is still being drawn
+            if (f > 0)
+                emit(*lanes[static_cast<std::size_t>((f - 1) % 2)]);
+        }
+        if (ok && frames > 0)
+            emit(*lanes[static_cast<std::size_t>((frames - 1) % 2)]);
+        while (!inFlight.empty()) {
+            ok = inFlight.front().get() && ok;
+            inFlight.pop_front();
+        }
+    }
+    ok = (toStdout ? std::fflush(out) == 0 : std::fclose(out) == 0) && ok;
+    if (!ok) {
+        std::fprintf(stderr, "replay_video: writing '%s' failed\n", outPath.string().c_str());
+        return 1;
+    }
+
+    const double wallS  = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    const double videoS = static_cast<double>(frames) / fps;
+    std::fprintf(stderr, "replay_video: %lld frames (%.1f s at %d fps, %ux%u) in %.1f s, %.1fx real time -> %s\n",
+                 static_cast<long long>(frames), videoS, fps, width, height, wallS,
+                 wallS > 0.0 ? videoS / wallS : 0.0, toStdout ? "stdout" : outPath.string().c_str());
+    return 0;
+}
@@ -0,0 +1,117 @@
+// tools/respack.cpp
+// Build step: packs selected sub-folders of resources/ into resources.pak
+// (layout in core/ResourcePack.hpp).
+//
+//   respack <out.pak> <resources-dir> <subdir>...
+#include "core/ResourcePack.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+using namespace Tetris;
+
+struct Item {
+    std::string   name;   // path below the resources dir, '/'-separated
+    fs::path      source;
+    std::uint64_t offset = 0;
+    std::uint64_t size   = 0;
+};
+
+template<class T>
+static void writePod(std::ofstream& out, const T& v) {
+    out.write(reinterpret_cast<const char*>(&v), sizeof(T));
+}
+
+static void padTo(std::ofstream& out, std::uint64_t& pos, std::uint64_t align) {
+    static const char zeros[kPakAlign] = {};
+    const std::uint64_t pad = (align - pos % align) % align;
+    out.write(zeros, static_cast<std::streamsize>(pad));
+    pos += pad;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 4) {
+        std::fprintf(stderr, "usage: respack <out.pak> <resources-dir> <subdir>...\n");
+        return 2;
+    }
+
+    const fs::path outPath = argv[1];
+    const fs::path root    = argv[2];
+
+    std::vector<Item> items;
+    for (int i = 3; i < argc; ++i) {
+        const fs::path dir = root / argv[i];
+        if (!fs::is_directory(dir)) {
+            std::fprintf(stderr, "respack: %s is not a directory\n", dir.string().c_str());
+            return 1;
+        }
+        for (const auto& e : fs::recursive_directory_iterator(dir)) {
+            if (!e.is_regular_file()) continue;
+            Item it;
+            it.name   = fs::relative(e.path(), root).generic_string();
+            it.source = e.path();
+            items.push_back(std::move(it));
+        }
+    }
+    std::sort(items.begin(), items.end(),
+              [](const Item& a, const Item& b) { return a.name < b.name; });
+
+    std::ofstream out(outPath, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!out) {
+        std::fprintf(stderr, "respack: cannot write %s\n", outPath.string().c_str());
+        return 1;
+    }
+
+    PakHeader hdr{};
+    std::memcpy(hdr.magic, kPakMagic, sizeof(kPakMagic));
+    hdr.version = kPakVersion;
+    hdr.count   = static_cast<std::uint32_t>(items.size());
+    writePod(out, hdr); // patched below once the index position is known
+
+    std::uint64_t pos = sizeof(PakHeader);
+    for (auto& it : items) {
+        padTo(out, pos, kPakAlign);
+
+        std::ifstream in(it.source, std::ios::in | std::ios::binary);
+        const std::vector<char> bytes((std::istreambuf_iterator<char>(in)),
+                                      std::istreambuf_iterator<char>());
+        if (!in.good() && !in.eof()) {
+            std::fprintf(stderr, "respack: failed to read %s\n", it.source.string().c_str());
+            return 1;
+        }
+
+        it.offset = pos;
+        it.size   = bytes.size();
+        out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+        pos += bytes.size();
+    }
+
+    padTo(out, pos, kPakAlign);
+    hdr.indexOffset = pos;
+    for (const auto& it : items) {
+        writePod(out, it.offset);
+        writePod(out, it.size);
+        writePod(out, static_cast<std::uint32_t>(it.name.size()));
+        out.write(it.name.data(), static_cast<std::streamsize>(it.name.size()));
+        pos += 8 + 8 + 4 + it.name.size();
+    }
+    hdr.indexSize = pos - hdr.indexOffset;
+
+    out.seekp(0);
+    writePod(out, hdr);
+    if (!out) {
+        std::fprintf(stderr, "respack: write error on %s\n", outPath.string().c_str());
+        return 1;
+    }
+
+    std::printf("respack: %zu files, %llu bytes -> %s\n", items.size(),
+                static_cast<unsigned long long>(pos), outPath.string().c_str());
+    return 0;
+}
@@ -0,0 +1,143 @@
+// tools/telemetry_tail.cpp
+// Follows the game's shared-memory telemetry ring and prints
+// one line per frame (or a summary per interval).
+//
+//   telemetry_tail [--name tetris_srs] [--summary ms]
+//
+// Start the game with --telemetry [name] first. The reader never blocks the
+// game; if it falls more than a ring's worth behind, the skipped frames are
+// reported and it resynchronises on the newest sample.
+#include "core/Telemetry.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+
+using namespace Tetris;
+
+static const char* modeName(std::uint64_t mode) {
+    switch (mode) {
+        case 0: return "title";
+        case 1: return "playing";
+        case 2: return "config";
+        default: return "?";
+    }
+}
+
+// Seqlock read of sample `idx`; false if the slot was (being) overwritten.
+static bool readSample(TelemetryHeader* h, std::uint64_t idx, TelemetrySample& out) {
+    TelemetrySlot* slot = telemetrySlots(h) + idx % h->capacity;
+    const std::uint64_t expected = 2 * idx + 2;
+
+    if (slot->seq.load(std::memory_order_acquire) != expected)
+        return false;
+    std::uint64_t words[kTelemetryWords];
+    for (std::size_t i = 0; i < kTelemetryWords; ++i)
+        words[i] = std::atomic_ref<std::uint64_t>(slot->words[i]).load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot->seq.load(std::memory_order_relaxed) != expected)
+        return false;
+
+    std::memcpy(&out, words, sizeof(out));
+    return true;
+}
+
+int main(int argc, char** argv) {
+    std::string name = "tetris_srs";
+    int summaryMs = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--name") && i + 1 < argc) {
+            name = argv[++i];
+        } else if (!std::strcmp(argv[i], "--summary") && i + 1 < argc) {
+            summaryMs = std::atoi(argv[++i]);
+        } else {
+            std::fprintf(stderr, "usage: %s [--name tetris_srs] [--summary ms]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    SharedMemory shm;
+    if (!shm.openReadOnly(name) || shm.size() < sizeof(TelemetryHeader)) {
+        std::fprintf(stderr, "telemetry_tail: no telemetry segment '%s' (start the game with --telemetry)\n",
+                     name.c_str());
+        return 1;
+    }
+    auto* h = static_cast<TelemetryHeader*>(shm.data()); // mapped read-only
+    if (std::memcmp(h->magic, kTelemetryMagic, sizeof(kTelemetryMagic)) != 0
+        || h->version != kTelemetryVersion
+        || h->sampleSize != sizeof(TelemetrySample)
+        || shm.size() < telemetryMappingSize(h->capacity)) {
+        std::fprintf(stderr, "telemetry_tail: '%s' is not a compatible telemetry segment\n", name.c_str());
+        return 1;
+    }
+
+    auto& writeIndex = h->writeIndex;
+    std::uint64_t next = writeIndex.load(std::memory_order_acquire);
+
+    if (!summaryMs)
+        std::printf("%10s %9s %5s %6s %7s %6s %s\n",
+                    "frame", "ms", "ticks", "events", "pieces", "lines", "mode");
+
+    // interval summary
+    using clock = std::chrono::steady_clock;
+    auto   windowStart = clock::now();
+    double sumMs = 0.0, maxMs = 0.0;
+    std::uint64_t frames = 0, ticks = 0, events = 0;
+    TelemetrySample last;
+
+    for (;;) {
+        const std::uint64_t head = writeIndex.load(std::memory_order_acquire);
+        if (head - next > h->capacity) {
+            std::fprintf(stderr, "telemetry_tail: skipped %llu frames\n",
+                         static_cast<unsigned long long>(head - next - 1));
+            next = head - 1;
+        }
+
+        while (next < head) {
+            TelemetrySample s;
+            if (!readSample(h, next, s)) {
+                next = writeIndex.load(std::memory_order_acquire) - 1; // lapped
+                continue;
+            }
+            ++next;
+
+            if (!summaryMs) {
+                std::printf("%10llu %9.3f %5llu %6llu %7llu %6llu %s\n",
+                            static_cast<unsigned long long>(s.frameIndex), s.frameMs,
+                            static_cast<unsigned long long>(s.simTicks),
+                            static_cast<unsigned long long>(s.inputEvents),
+                            static_cast<unsigned long long>(s.piecesPlaced),
+                            static_cast<unsigned long long>(s.linesCleared),
+                            modeName(s.mode));
+            } else {
+                ++frames;
+                sumMs  += s.frameMs;
+                maxMs   = s.frameMs > maxMs ? s.frameMs : maxMs;
+                ticks  += s.simTicks;
+                events += s.inputEvents;
+                last    = s;
+            }
+        }
+
+        if (summaryMs && clock::now() - windowStart >= std::chrono::milliseconds(summaryMs)) {
+            if (frames)
+                std::printf("frames %5llu  mean %7.3f ms  max %7.3f ms  ticks %6llu  events %5llu  "
+                            "pieces %5llu  lines %4llu  %s\n",
+                            static_cast<unsigned long long>(frames), sumMs / frames, maxMs,
+                            static_cast<unsigned long long>(ticks),
+                            static_cast<unsigned long long>(events),
+                            static_cast<unsigned long long>(last.piecesPlaced),
+                            static_cast<unsigned long long>(last.linesCleared),
+                            modeName(last.mode));
+            windowStart = clock::now();
+            sumMs = maxMs = 0.0;
+            frames = ticks = events = 0;
+        }
+        std::fflush(stdout);
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+}